@@ -8,6 +8,10 @@ public class DenisesVRExpansionExpansion : ModuleRules
     {
         PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
 
+        // Inline capacity of ASlotableActor's slot lists (FItemSlotCandidates). Raise it for setups with many slots in reach at once.
+        // 16 covers a 30 cm collider over slots with 50 cm triggers placed 40 cm apart, the ItemSlotBenchmark defaults.
+        PublicDefinitions.Add("ITEMSLOT_INLINE_CANDIDATES=16");
+
         // Common dependencies for both editor and game
         PublicDependencyModuleNames.AddRange(
             new string[]
@@ -26,9 +30,15 @@ public class DenisesVRExpansionExpansion : ModuleRules
                 "VRExpansionPlugin",
                 "Slate",
                 "SlateCore",
+                "DeveloperSettings",
+                "ReplicationGraph",
+                "IrisCore",
             }
         );
 
+        // Defines UE_WITH_IRIS, which guards the UItemSlotNetObjectFilter hookup.
+        SetupIrisSupport(Target);
+
         // Editor-specific dependencies
         if (Target.Type == TargetRules.TargetType.Editor)
         {
@@ -38,6 +48,7 @@ public class DenisesVRExpansionExpansion : ModuleRules
         if (Target.Type == TargetRules.TargetType.Editor)
         {
             PublicDependencyModuleNames.Add("UnrealEd");
+            PrivateDependencyModuleNames.Add("AssetRegistry");
         }
 
         PrivateDependencyModuleNames.AddRange(
@@ -3,6 +3,14 @@
 #include "DenisesVRExpansionExpansion.h"
 #include "ItemSlotDetailsModule.h"
 
+#if WITH_EDITOR
+#include "UnrealEdGlobals.h"
+#include "Editor/UnrealEdEngine.h"
+#include "Misc/CoreDelegates.h"
+#include "ItemSlotContainerComponent.h"
+#include "ItemSlotContainerVisualizer.h"
+#endif
+
 #define LOCTEXT_NAMESPACE "FDenisesVRExpansionExpansionModule"
 
 void FDenisesVRExpansionExpansionModule::StartupModule()
@@ -13,6 +21,27 @@ void FDenisesVRExpansionExpansionModule::StartupModule()
 	    // Register our custom detail customization class
     FPropertyEditorModule& PropertyModule = FModuleManager::GetModuleChecked<FPropertyEditorModule>("PropertyEditor");
     PropertyModule.RegisterCustomClassLayout("ItemSlot", FOnGetDetailCustomizationInstance::CreateStatic(&ItemSlotDetails::MakeInstance));
+
+	// GUnrealEd doesn't exist yet when this module loads with the engine, only when it is loaded later on.
+	if (GEngine)
+		registerComponentVisualizers();
+	else
+		postEngineInitHandle = FCoreDelegates::OnPostEngineInit.AddRaw(this, &FDenisesVRExpansionExpansionModule::registerComponentVisualizers);
+#endif
+}
+
+void FDenisesVRExpansionExpansionModule::registerComponentVisualizers()
+{
+#if WITH_EDITOR
+	FCoreDelegates::OnPostEngineInit.Remove(postEngineInitHandle);
+	postEngineInitHandle.Reset();
+
+	if (GUnrealEd)
+	{
+		TSharedPtr<FComponentVisualizer> visualizer = MakeShared<FItemSlotContainerVisualizer>();
+		GUnrealEd->RegisterComponentVisualizer(UItemSlotContainerComponent::StaticClass()->GetFName(), visualizer);
+		visualizer->OnRegister();
+	}
 #endif
 }
 
@@ -28,6 +57,12 @@ void FDenisesVRExpansionExpansionModule::ShutdownModule()
         FPropertyEditorModule& PropertyModule = FModuleManager::GetModuleChecked<FPropertyEditorModule>("PropertyEditor");
         PropertyModule.UnregisterCustomClassLayout("ItemSlot");
     }
+
+	FCoreDelegates::OnPostEngineInit.Remove(postEngineInitHandle);
+	postEngineInitHandle.Reset();
+
+	if (GUnrealEd)
+		GUnrealEd->UnregisterComponentVisualizer(UItemSlotContainerComponent::StaticClass()->GetFName());
 #endif
 }
 
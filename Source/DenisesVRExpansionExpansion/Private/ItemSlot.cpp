@@ -5,6 +5,14 @@
 #include "UObject/ConstructorHelpers.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "Net/UnrealNetwork.h"
+#include "ItemSlotSubsystem.h"
+#include "ItemSlotSettings.h"
+#include "ItemSlotStats.h"
+#include "ItemSlotLayout.h"
+#include "ItemSlotContainerComponent.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
 
 #if WITH_EDITOR
 #include <Editor.h>
@@ -30,28 +38,145 @@ UItemSlot::UItemSlot()
 void UItemSlot::BeginPlay()
 {
 	Super::BeginPlay();
-	setupMulti();
+
+	// Same placement setupTriggerComponent uses, kept relative to this component so the bounds follow it when the owner moves.
+	FVector triggerPosition = GetAttachmentRoot()->GetComponentTransform().TransformPosition(triggerVisuals.RelativePosition);
+	auto triggerRotation = GetAttachmentRoot()->GetComponentTransform().TransformRotation(FQuat(triggerVisuals.RelativeRotation));
+	triggerToSlotTransform = FTransform(triggerRotation, triggerPosition).GetRelativeTransform(FTransform(GetComponentQuat(), GetComponentLocation()));
+
+	UItemSlotSubsystem* registry = UItemSlotSubsystem::Get(this);
+	if (registry)
+	{
+		registry->RegisterSlot(this);
+		TransformUpdated.AddUObject(this, &UItemSlot::onSlotTransformUpdated);
+	}
+
+	// Setup runs locally on every machine. Only the server's trigger component is costly, the subsystem spreads those over frames.
+	SetVisibility(false);
+
+	if (!GetOwner()->HasAuthority() || bUseSpatialRegistryOnly || UItemSlotSettings::Get()->bLazySlotTriggers)
+		bReady = true;
+	else if (registry)
+		registry->QueueSlotSetup(this);
+	else
+		finishSetup();
 }
 
-void UItemSlot::setupMulti_Implementation()
+void UItemSlot::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	setupVisualsComponent();
+	TransformUpdated.RemoveAll(this);
+	hidePreview();
+
+	if (UItemSlotSubsystem* registry = UItemSlotSubsystem::Get(this))
+		registry->UnregisterSlot(this);
 
-	if (GetOwner()->HasAuthority())
-		setupTriggerComponent();
+	Super::EndPlay(EndPlayReason);
+}
 
-	this->SetVisibility(false);
+void UItemSlot::onSlotTransformUpdated(USceneComponent* updatedComponent, EUpdateTransformFlags updateTransformFlags, ETeleportType teleport)
+{
+	if (UItemSlotSubsystem* registry = UItemSlotSubsystem::Get(this))
+		registry->MarkSlotMoved(this);
+}
+
+FBox UItemSlot::GetTriggerBounds() const
+{
+	const FTransform triggerTransform = triggerToSlotTransform * FTransform(GetComponentQuat(), GetComponentLocation());
+
+	// Matches the shapes setupTriggerComponent spawns: 50 unit radius / extent with absolute scale.
+	switch (editorCollisionShape)
+	{
+	case 2:
+	{
+		const FVector extent = triggerVisuals.Scale.GetAbs() * 50.0f;
+		return FBox(-extent, extent).TransformBy(triggerTransform);
+	}
+	default:
+	{
+		const float radius = triggerVisuals.Scale.GetAbsMin() * 50.0f;
+		return FBox::BuildAABB(triggerTransform.GetLocation(), FVector(radius));
+	}
+	}
+}
+
+void UItemSlot::finishSetup()
+{
+	setupTriggerComponent();
+	bReady = true;
 }
 
 bool UItemSlot::CheckForCompatibility(const ASlotableActor* actor)
 {
-	int index = acceptedActors.IndexOfByKey(actor->GetClass());
-	if (index != INDEX_NONE)
-		return true;
-	else
-		return false;
+	if (!actor) { return false; }
+
+	const int32 classId = actor->GetSlotClassIndex();
+	if (registryIndex != INDEX_NONE && classId != INDEX_NONE)
+		return compatibilityBits.IsValidIndex(classId) && compatibilityBits[classId];
+
+	// Not indexed yet (actor or slot hasn't begun play), fall back to checking the class directly.
+	return acceptsClass(actor->GetClass());
 }
 
+bool UItemSlot::acceptsClass(const UClass* actorClass) const
+{
+	if (!actorClass) { return false; }
+
+	for (const TSubclassOf<ASlotableActor>& acceptedClass : acceptedActors)
+	{
+		if (!acceptedClass) { continue; }
+
+		if (acceptedClass == actorClass)
+			return true;
+		if (bAcceptChildClasses && actorClass->IsChildOf(acceptedClass))
+			return true;
+	}
+	return false;
+}
+
+void UItemSlot::rebuildCompatibilityBits(UItemSlotSubsystem* registry)
+{
+	// Accepted classes get their IDs here, so a slot can match them before any instance has begun play.
+	for (const TSubclassOf<ASlotableActor>& acceptedClass : acceptedActors)
+		registry->RegisterSlotableClass(acceptedClass);
+
+	const int32 classNr = registry->NumSlotableClasses();
+	compatibilityBits.Init(false, classNr);
+
+	for (int32 classId = 0; classId < classNr; classId++)
+	{
+		if (acceptsClass(registry->GetSlotableClass(classId)))
+			compatibilityBits[classId] = true;
+	}
+}
+
+void UItemSlot::updateCompatibilityBit(int32 classId, const UClass* actorClass)
+{
+	if (compatibilityBits.Num() <= classId)
+		compatibilityBits.Add(false, classId + 1 - compatibilityBits.Num());
+
+	compatibilityBits[classId] = acceptsClass(actorClass);
+}
+
+const FSlotableActorVisuals* UItemSlot::findVisualsFor(const UClass* actorClass) const
+{
+	for (const UClass* visualsClass = actorClass; visualsClass; visualsClass = visualsClass->GetSuperClass())
+	{
+		const FSlotableActorVisuals* visuals = layout ? layout->FindVisuals(visualsClass) : actorVisuals_Map.Find(visualsClass);
+		if (visuals)
+			return visuals;
+
+		if (!bAcceptChildClasses) { break; }
+	}
+	return nullptr;
+}
+
+bool UItemSlot::IsAvailableFor(const ASlotableActor* actor) const
+{
+	if (netState.State == EItemSlotState::available)
+		return true;
+
+	return netState.State == EItemSlotState::reserved && netState.Actor == actor;
+}
 
 void UItemSlot::E_ToggleVisibility()
 {
@@ -76,7 +201,7 @@ void UItemSlot::E_SetPreviewVisuals(const FSlotableActorVisuals visuals)
 	else
 		UMeshComponent::SetMaterial(0, nullptr);
 
-	UStaticMeshComponent::SetStaticMesh(visuals.Mesh);
+	UStaticMeshComponent::SetStaticMesh(visuals.Mesh.LoadSynchronous());
 	UStaticMeshComponent::SetWorldScale3D(visuals.Scale);
 	UStaticMeshComponent::SetRelativeLocation(visuals.RelativePosition);
 	UStaticMeshComponent::SetRelativeRotation(visuals.RelativeRotation);
@@ -88,7 +213,7 @@ void UItemSlot::E_SetVisibility(bool hidden) { this->SetVisibility(hidden); }
 void UItemSlot::E_ResetActorMeshToRootTransform(TSubclassOf<class ASlotableActor> actorToReset_Key)
 {
 
-	if (actorVisuals_Map.Contains(actorToReset_Key))
+	if (FSlotableActorVisuals* visualsToReset = editVisualsOf(actorToReset_Key))
 	{
 		if (currentlyDisplayedSlotableActor == actorToReset_Key)
 		{
@@ -104,9 +229,8 @@ void UItemSlot::E_ResetActorMeshToRootTransform(TSubclassOf<class ASlotableActor
 			}
 		}
 
-		auto visualsToReset = actorVisuals_Map[actorToReset_Key];
-		visualsToReset.RelativePosition = rootVisuals.RelativePosition;
-		visualsToReset.RelativeRotation = rootVisuals.RelativeRotation;
+		visualsToReset->RelativePosition = rootVisuals.RelativePosition;
+		visualsToReset->RelativeRotation = rootVisuals.RelativeRotation;
 	}
 }
 
@@ -149,10 +273,11 @@ void UItemSlot::E_ModifyAcceptedActorMesh(TSubclassOf<class ASlotableActor> acto
 {
 	SaveEdit();
 
-	if (actorVisuals_Map.Contains(actorToModify_Key))
+	const FSlotableActorVisuals* visuals = layout ? layout->FindVisuals(actorToModify_Key) : actorVisuals_Map.Find(actorToModify_Key);
+	if (visuals)
 	{
 		currentlyDisplayedSlotableActor = actorToModify_Key;
-		E_SetPreviewVisuals(actorVisuals_Map[currentlyDisplayedSlotableActor]);
+		E_SetPreviewVisuals(*visuals);
 
 		if (IsSelectedInEditor())
 		{
@@ -279,7 +404,7 @@ void UItemSlot::SaveRootTransform()
 	rootVisuals.RelativeRotation = GetRelativeRotation();
 	rootVisuals.Scale = GetComponentScale();
 
-	UE_LOG(LogTemp, Log, TEXT("Saved root."));
+	UE_LOG(LogItemSlots, Log, TEXT("Saved root."));
 }
 
 void UItemSlot::SaveMeshTransform()
@@ -290,12 +415,13 @@ void UItemSlot::SaveMeshTransform()
 		GEditor->RedrawLevelEditingViewports(true);
 	}
 
-	if (actorVisuals_Map.Contains(currentlyDisplayedSlotableActor))
+	if (FSlotableActorVisuals* visuals = editVisualsOf(currentlyDisplayedSlotableActor))
 	{
-		actorVisuals_Map[currentlyDisplayedSlotableActor].RelativePosition = GetRelativeLocation();
-		actorVisuals_Map[currentlyDisplayedSlotableActor].RelativeRotation = GetRelativeRotation();
-		actorVisuals_Map[currentlyDisplayedSlotableActor].Scale = GetComponentScale();
-		UE_LOG(LogTemp, Log, TEXT("Saved slot mesh: '%s'"), *currentlyDisplayedSlotableActor->GetName());
+		visuals->RelativePosition = GetRelativeLocation();
+		visuals->RelativeRotation = GetRelativeRotation();
+		visuals->Scale = GetComponentScale();
+		UE_LOG(LogItemSlots, Log, TEXT("Saved slot mesh: '%s'%s"), *currentlyDisplayedSlotableActor->GetName(),
+			layout ? *FString::Printf(TEXT(" in shared layout '%s'"), *layout->GetName()) : TEXT(""));
 	}
 
 	if (GEditor)
@@ -318,7 +444,7 @@ void UItemSlot::SaveTriggerTransform()
 	triggerVisuals.Scale = GetComponentScale();
 
 
-	UE_LOG(LogTemp, Log, TEXT("Saved trigger mesh."));
+	UE_LOG(LogItemSlots, Log, TEXT("Saved trigger mesh."));
 }
 
 /// <summary>
@@ -346,19 +472,44 @@ void UItemSlot::addActorToVisualsMap(TSubclassOf<class ASlotableActor> newActor)
 	FSlotableActorVisuals gfx;
 	auto obj = newActor.GetDefaultObject();
 	gfx.ID = newActor->GetName();
-	gfx.Mesh = obj->PreviewMesh;
+	gfx.Mesh = obj->GetPreviewMesh();
 	gfx.Scale = obj->MeshScale;
 	gfx.RelativePosition = rootVisuals.RelativePosition;
 	gfx.RelativeRotation = rootVisuals.RelativeRotation;
 
+	// Other slots may already have placed this class in the shared layout, only missing entries are added there.
+	if (layout)
+	{
+		if (!layout->FindVisuals(newActor))
+		{
+			layout->Modify();
+			layout->SetVisuals(newActor, gfx);
+		}
+		return;
+	}
+
 	if (!actorVisuals_Map.Contains(newActor))
 		actorVisuals_Map.Add(newActor, gfx);
 	else
 		actorVisuals_Map[newActor] = gfx;
 }
 
+void UItemSlot::E_UseLayout(UItemSlotLayout* newLayout)
+{
+	Modify();
+	layout = newLayout;
+	actorVisuals_Map.Empty();
+}
+
 void UItemSlot::removeActorFromVisualsArray(TSubclassOf<class ASlotableActor> removeActor)
 {
+	if (layout)
+	{
+		if (currentlyDisplayedSlotableActor == removeActor)
+			E_ModifyRootComponent();
+		return;
+	}
+
 	if (actorVisuals_Map.Contains(removeActor))
 	{
 		if (currentlyDisplayedVisuals.ID.Equals(actorVisuals_Map[removeActor].ID))
@@ -368,110 +519,104 @@ void UItemSlot::removeActorFromVisualsArray(TSubclassOf<class ASlotableActor> re
 	}
 }
 
+FSlotableActorVisuals* UItemSlot::editVisualsOf(const UClass* actorClass)
+{
+	if (!actorClass) { return nullptr; }
+
+	if (layout)
+		return layout->E_EditVisuals(actorClass);
+
+	return actorVisuals_Map.Find(actorClass);
+}
+
 #endif
 
 void UItemSlot::ReserveForActor_Server_Implementation(ASlotableActor* actor, const EControllerHand handSide)
 {
-	if (currentState == EItemSlotState::available)
-	{
-		int index = acceptedActors.IndexOfByKey(actor->GetClass());
-		if (index != INDEX_NONE)
-		{
-			SetClientVisualsOnReserve(actor, handSide);
-		}
-		reservedForActor = actor;
-		currentState = EItemSlotState::reserved;
-		OnOccupied.ExecuteIfBound(this);
-	}
+	countRpc();
+	transition<EItemSlotEvent::Reserve>(actor, handSide);
 }
-void UItemSlot::SetClientVisualsOnReserve_Implementation(ASlotableActor* actor, const EControllerHand handSide)
+
+void UItemSlot::ReceiveActorInstigator_Implementation(ASlotableActor* actor)
 {
-	if (actorVisuals_Map.Contains(actor->GetClass()))
-	{
-		currentlyDisplayedVisuals = *actorVisuals_Map.Find(actor->GetClass());
-		SetVisuals(currentlyDisplayedVisuals, handSide);
-	}
+	countRpc();
+	transition<EItemSlotEvent::Receive>(actor);
 }
 
-void UItemSlot::SetVisuals_Implementation(const FSlotableActorVisuals visualProperties, const EControllerHand handSide)
+bool UItemSlot::insertActor(ASlotableActor* actor)
 {
-	if (visualsComponent)
-	{
-		FVector newPosition = GetAttachmentRoot()->GetComponentTransform().TransformPosition(visualProperties.RelativePosition);
-		auto newRotation = GetAttachmentRoot()->GetComponentTransform().TransformRotation(FQuat(visualProperties.RelativeRotation));
-		visualsComponent->SetWorldLocation(newPosition);
-		visualsComponent->SetWorldRotation(newRotation);
-		visualsComponent->SetWorldScale3D(visualProperties.Scale);
-		visualsComponent->SetStaticMesh(visualProperties.Mesh);
-
-		switch (handSide)
-		{
-		case EControllerHand::Left:
-			visualsComponent->SetMaterial(0, leftHandMaterial);
-			break;
-		case EControllerHand::Right:
-			visualsComponent->SetMaterial(0, rightHandMaterial);
-			break;
-		}
-
-		visualsComponent->SetVisibility(true);
-	}
+	return transition<EItemSlotEvent::Insert>(actor);
 }
 
-void UItemSlot::ReceiveActorInstigator_Implementation(ASlotableActor* actor)
+bool UItemSlot::insertProxy(TSubclassOf<ASlotableActor> actorClass)
 {
-	if (actor == reservedForActor)
-	{
-		OnActorReceivedEvent.Broadcast();
-		actor->DisableComponentsSimulatePhysics();
-		actor->AttachToComponent(this, FAttachmentTransformRules::SnapToTargetNotIncludingScale);
-		auto colComp = actor->GetRootComponent();
-		auto castToMesh = Cast<UStaticMeshComponent>(colComp);
-		castToMesh->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	proxyRecord = FItemSlotProxyRecord();
+	proxyRecord.ActorClass = actorClass;
 
-		actor->SetActorRelativeLocation(visualsComponent->GetRelativeLocation());
-		actor->SetActorRelativeRotation(visualsComponent->GetRelativeRotation());
+	if (transition<EItemSlotEvent::InsertProxy>(nullptr)) { return true; }
 
-		reservedForActor = nullptr;
-		currentState = EItemSlotState::occupied;
+	proxyRecord = FItemSlotProxyRecord();
+	return false;
+}
 
-		SetVisualsOn_ActorReceive(actor);
+bool UItemSlot::dehydrate(UItemSlotSubsystem* registry)
+{
+	ASlotableActor* actor = Cast<ASlotableActor>(netState.Actor);
+	if (!actor) { return false; }
 
+	FItemSlotProxyRecord record;
+	record.ActorClass = actor->GetClass();
+	{
+		FMemoryWriter writer(record.Data);
+		actor->SerializeProxyData(writer);
 	}
-	else
-		GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor(150, 150, 150), TEXT("received enter request from an actor that is not the ReservedFor Actor."));
+
+	if (!transition<EItemSlotEvent::Dehydrate>(actor)) { return false; }
+
+	proxyRecord = MoveTemp(record);
+	registry->ReleaseProxyActor(actor);
+	return true;
 }
-void UItemSlot::SetVisualsOn_ActorReceive_Implementation(ASlotableActor* actor)
+
+bool UItemSlot::rehydrate(UItemSlotSubsystem* registry)
 {
-	actor->DisableComponentsSimulatePhysics();
-	actor->AttachToComponent(this, FAttachmentTransformRules::SnapToTargetNotIncludingScale);
-	auto colComp = actor->GetRootComponent();
-	auto castToMesh = Cast<UStaticMeshComponent>(colComp);
-	castToMesh->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	if (!netState.bProxy) { return false; }
+
+	ASlotableActor* actor = registry->AcquireProxyActor(proxyRecord.ActorClass, this);
+	if (!actor) { return false; }
 
-	actor->SetActorRelativeLocation(visualsComponent->GetRelativeLocation());
-	actor->SetActorRelativeRotation(visualsComponent->GetRelativeRotation());
+	{
+		FMemoryReader reader(proxyRecord.Data);
+		actor->SerializeProxyData(reader);
+	}
 
-	reservedForActor = nullptr;
-	currentState = EItemSlotState::occupied;
+	if (!transition<EItemSlotEvent::Rehydrate>(actor))
+	{
+		registry->ReleaseProxyActor(actor);
+		return false;
+	}
 
-	ReceiveActor();
-}
-void UItemSlot::ReceiveActor_Implementation()
-{
-	visualsComponent->SetVisibility(false);
+	proxyRecord = FItemSlotProxyRecord();
+	return true;
 }
 
 void UItemSlot::RemoveSlotableActor(ASlotableActor* actor)
 {
 	actor->DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
-	currentState = EItemSlotState::available;
-	OnAvailable.ExecuteIfBound(this);
-	OnActorExitEvent.Broadcast();
+
+	// Also reached on clients through the grip multicast, only the server owns the slot state.
+	if (!GetOwner()->HasAuthority()) { return; }
+
+	transition<EItemSlotEvent::Remove>(actor);
 }
 
-void UItemSlot::setupTriggerComponent_Implementation()
+void UItemSlot::setupTriggerComponent()
 {
+	// In lazy trigger mode UItemSlotSubsystem hands out a pooled trigger once a gripped actor comes near.
+	if (bUseSpatialRegistryOnly || UItemSlotSettings::Get()->bLazySlotTriggers) { return; }
+
+	ITEMSLOTS_SCOPE(SetupTrigger);
+
 	AActor* Owner = GetOwner();
 	USphereComponent* triggerAsSphere;
 	UBoxComponent* triggerAsBox;
@@ -500,61 +645,365 @@ void UItemSlot::setupTriggerComponent_Implementation()
 	if (colliderComponent)
 	{
 		GetOwner()->AddInstanceComponent(colliderComponent);
+		placeTrigger();
+	}
+}
+
+void UItemSlot::initContainerSlot(const FItemSlotContainerEntry& entry, UItemSlotContainerComponent& owningContainer, int32 entryIndex)
+{
+	container = &owningContainer;
+	containerIndex = entryIndex;
+
+	acceptedActors = entry.AcceptedActors;
+	bAcceptChildClasses = entry.bAcceptChildClasses;
+	layout = entry.Layout ? entry.Layout : owningContainer.DefaultLayout;
+	leftHandMaterial = owningContainer.LeftHandMaterial;
+	rightHandMaterial = owningContainer.RightHandMaterial;
+
+	// Trigger bounds for the registry grid, same shape a sphere trigger would have. The slot itself is the trigger center.
+	bUseSpatialRegistryOnly = true;
+	editorCollisionShape = 1;
+	const FTransform rootRelative = (entry.RelativeTransform * owningContainer.GetComponentTransform()).GetRelativeTransform(owningContainer.GetAttachmentRoot()->GetComponentTransform());
+	triggerVisuals.RelativePosition = rootRelative.GetLocation();
+	triggerVisuals.RelativeRotation = rootRelative.Rotator();
+	triggerVisuals.Scale = FVector(entry.TriggerRadius / 50.0f);
+
+	// Without a mesh and collision no render proxy or physics body is created for the slot.
+	SetStaticMesh(nullptr);
+	SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	SetGenerateOverlapEvents(false);
+	SetHiddenInGame(true);
+	PrimaryComponentTick.bCanEverTick = false;
+
+	// The slot stays addressable by name for RPCs and slot references, its state goes out with the container.
+	SetIsReplicated(false);
+}
+
+void UItemSlot::placeTrigger()
+{
+	FVector newPosition = GetAttachmentRoot()->GetComponentTransform().TransformPosition(triggerVisuals.RelativePosition);
+	auto newRotation = GetAttachmentRoot()->GetComponentTransform().TransformRotation(FQuat(triggerVisuals.RelativeRotation));
+	colliderComponent->SetWorldLocation(newPosition);
+	colliderComponent->SetWorldRotation(newRotation);
+
+	colliderComponent->SetCollisionProfileName("Trigger", true);
+	colliderComponent->SetCollisionResponseToChannel(ECollisionChannel::ECC_GameTraceChannel1, ECollisionResponse::ECR_Ignore);
+
+	colliderComponent->bHiddenInGame = false;
+	colliderComponent->SetUsingAbsoluteScale(true);
+	colliderComponent->SetWorldScale3D(triggerVisuals.Scale);
+	colliderComponent->SetVisibility(false);
+}
+
+bool UItemSlot::acquireLazyTrigger(UItemSlotSubsystem* registry)
+{
+	// Same shapes as setupTriggerComponent, a slot without a collision shape gets no trigger in lazy mode either.
+	if (editorCollisionShape != 1 && editorCollisionShape != 2) { return false; }
+
+	ITEMSLOTS_SCOPE(SetupTrigger);
+
+	const bool box = editorCollisionShape == 2;
+	colliderComponent = registry->BorrowTrigger(box);
+	if (!colliderComponent) { return false; }
 
-		FVector newPosition = GetAttachmentRoot()->GetComponentTransform().TransformPosition(triggerVisuals.RelativePosition);
-		auto newRotation = GetAttachmentRoot()->GetComponentTransform().TransformRotation(FQuat(triggerVisuals.RelativeRotation));
-		colliderComponent->SetWorldLocation(newPosition);
-		colliderComponent->SetWorldRotation(newRotation);
+	if (box)
+		Cast<UBoxComponent>(colliderComponent)->SetBoxExtent(FVector(50.0f, 50.0f, 50.0f));
+	else
+		Cast<USphereComponent>(colliderComponent)->SetSphereRadius(50.0f);
+
+	colliderComponent->AttachToComponent(this, FAttachmentTransformRules::SnapToTargetIncludingScale);
+	placeTrigger();
+	bLazyTrigger = true;
+	return true;
+}
 
-		colliderComponent->SetCollisionProfileName("Trigger", true);
-		colliderComponent->SetCollisionResponseToChannel(ECollisionChannel::ECC_GameTraceChannel1, ECollisionResponse::ECR_Ignore);
+void UItemSlot::releaseLazyTrigger(UItemSlotSubsystem* registry)
+{
+	registry->ReturnTrigger(colliderComponent);
+	colliderComponent = nullptr;
+	bLazyTrigger = false;
+}
 
-		colliderComponent->bHiddenInGame = false;
-		colliderComponent->SetUsingAbsoluteScale(true);
-		colliderComponent->SetWorldScale3D(triggerVisuals.Scale);
-		colliderComponent->SetVisibility(false);
+void UItemSlot::ActorOutOfRangeEventInstigation_Implementation(ASlotableActor* actor)
+{
+	countRpc();
+	transition<EItemSlotEvent::CancelReservation>(actor);
+}
+
+template<EItemSlotEvent Event>
+bool UItemSlot::transition(ASlotableActor* actor, EControllerHand handSide)
+{
+	using FTransition = TItemSlotTransition<Event>;
+
+	if (!(FTransition::FromStates & ItemSlotStateMachine::StateBit(netState.State)) || !FTransition::Guard(*this, netState, actor))
+	{
+		INC_DWORD_STAT(STAT_ItemSlots_RejectedTransitions);
+		UE_LOG(LogItemSlots, Verbose, TEXT("%s: rejected %s from %s while %s for %s"),
+			*GetName(), ItemSlotStateMachine::EventName(Event), *GetNameSafe(actor), *UEnum::GetValueAsString(netState.State.GetValue()), *GetNameSafe(netState.Actor));
+		return false;
 	}
+
+	commitNetState(FTransition::MakeState(*this, netState, actor, handSide), static_cast<uint8>(Event));
+	FTransition::OnCommitted(*this);
+	return true;
 }
 
-void UItemSlot::setupVisualsComponent_Implementation()
+bool UItemSlot::replayEvent(EItemSlotEvent event, ASlotableActor* actor, EControllerHand handSide)
 {
-	AActor* Owner = GetOwner();
-	visualsComponent = Cast<UStaticMeshComponent>(Owner->AddComponentByClass(
-		UStaticMeshComponent::StaticClass(),
-		true,
-		FTransform::Identity,
-		false));
+	switch (event)
+	{
+	case EItemSlotEvent::Reserve:			return transition<EItemSlotEvent::Reserve>(actor, handSide);
+	case EItemSlotEvent::CancelReservation:	return transition<EItemSlotEvent::CancelReservation>(actor, handSide);
+	case EItemSlotEvent::Receive:			return transition<EItemSlotEvent::Receive>(actor, handSide);
+	case EItemSlotEvent::Remove:			return transition<EItemSlotEvent::Remove>(actor, handSide);
+	case EItemSlotEvent::Insert:			return transition<EItemSlotEvent::Insert>(actor, handSide);
+	case EItemSlotEvent::InsertProxy:		return transition<EItemSlotEvent::InsertProxy>(actor, handSide);
+	case EItemSlotEvent::Dehydrate:			return transition<EItemSlotEvent::Dehydrate>(actor, handSide);
+	case EItemSlotEvent::Rehydrate:			return transition<EItemSlotEvent::Rehydrate>(actor, handSide);
+	}
+	return false;
+}
 
-	visualsComponent->AttachToComponent(this, FAttachmentTransformRules::SnapToTargetNotIncludingScale);
-	GetOwner()->AddInstanceComponent(visualsComponent);
+void UItemSlot::commitNetState(const FItemSlotNetState& newState, uint8 event)
+{
+	const FItemSlotNetState previousState = netState;
+	netState = newState;
+	if (UItemSlotContainerComponent* owningContainer = container.Get())
+		owningContainer->onSlotStateCommitted(containerIndex, netState);
+	else
+		MARK_PROPERTY_DIRTY_FROM_NAME(UItemSlot, netState, this);
 
-	visualsComponent->SetGenerateOverlapEvents(false);
-	visualsComponent->SetSimulatePhysics(false);
-	visualsComponent->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
+	// NotifySlotStateChanged also journals the transition and queues the OnOccupied / OnAvailable broadcast.
+	if (UItemSlotSubsystem* registry = UItemSlotSubsystem::Get(this))
+		registry->NotifySlotStateChanged(this, previousState, netState, event);
 
-	visualsComponent->SetUsingAbsoluteScale(true);
-	visualsComponent->SetCastShadow(false);
-	visualsComponent->SetVisibility(false);
+	// OnRep doesn't run on the server, apply the same local side effects here.
+	applyNetState(previousState);
 }
 
-void UItemSlot::ActorOutOfRangeEventInstigation_Implementation(ASlotableActor* actor)
+void UItemSlot::countRpc()
 {
-	ActorOutOfRangeEventMulti(actor);
+	if (UItemSlotSubsystem* registry = UItemSlotSubsystem::Get(this))
+		registry->CountRpc();
 }
-void UItemSlot::ActorOutOfRangeEventMulti_Implementation(ASlotableActor* actor)
+
+void UItemSlot::OnRep_NetState(const FItemSlotNetState& previousState)
 {
-	if (actor == reservedForActor)
+	applyNetState(previousState);
+}
+
+void UItemSlot::applyNetState(const FItemSlotNetState& previousState)
+{
+	ITEMSLOTS_SCOPE(ApplyNetState);
+	ASlotableActor* stateActor = Cast<ASlotableActor>(netState.Actor);
+
+	if (netState.State == EItemSlotState::occupied && stateActor)
+		placeOccupant(stateActor);
+
+	if (GetNetMode() == NM_DedicatedServer) { return; }
+
+	// The server's decision arrived, whichever it was. The predicting actor re-predicts from here if it was someone else.
+	if (predictedFor && netState.State != EItemSlotState::available)
+		predictedFor = nullptr;
+
+	if (previousState.State != netState.State)
+	{
+		if (UItemSlotSubsystem* registry = UItemSlotSubsystem::Get(this))
+			registry->MarkGhostPreviewsDirty();
+	}
+
+	refreshPreview();
+}
+
+void UItemSlot::refreshPreview()
+{
+	const FSlotableActorVisuals* visuals = findVisualsForNetState();
+	if (netState.State == EItemSlotState::reserved && visuals)
+	{
+		currentlyDisplayedVisuals = *visuals;
+		showPreview(*visuals, netState.HandSide);
+		return;
+	}
+
+	if (netState.bProxy && visuals)
 	{
-		currentState = EItemSlotState::available;
-		reservedForActor = nullptr;
-		ActorOutOfRangeEvent(actor);
-		OnAvailable.ExecuteIfBound(this);
+		currentlyDisplayedVisuals = *visuals;
+		showProxy(*visuals);
+		return;
+	}
 
+	if (predictedFor && netState.State == EItemSlotState::available)
+	{
+		if (const FSlotableActorVisuals* predictedVisuals = findVisualsFor(predictedFor->GetClass()))
+		{
+			currentlyDisplayedVisuals = *predictedVisuals;
+			showPreview(*predictedVisuals, predictedHandSide);
+			return;
+		}
 	}
+
+	hidePreview();
 }
-void UItemSlot::ActorOutOfRangeEvent_Implementation(ASlotableActor* actor)
+
+void UItemSlot::SetPredictedReservation(ASlotableActor* actor, const EControllerHand handSide)
 {
-	visualsComponent->SetVisibility(false);
+	if (GetNetMode() == NM_DedicatedServer) { return; }
+
+	predictedFor = actor;
+	predictedHandSide = handSide;
+	refreshPreview();
+}
+
+void UItemSlot::ClearPredictedReservation(const ASlotableActor* actor)
+{
+	if (!predictedFor || predictedFor != actor) { return; }
+
+	predictedFor = nullptr;
+	refreshPreview();
+}
+
+int32 UItemSlot::acceptedIndexFor(const UClass* actorClass) const
+{
+	int32 index = acceptedActors.IndexOfByKey(actorClass);
+	if (index != INDEX_NONE || !bAcceptChildClasses || !actorClass)
+		return index;
+
+	return acceptedActors.IndexOfByPredicate([actorClass](const TSubclassOf<ASlotableActor>& acceptedClass)
+		{
+			return acceptedClass && actorClass->IsChildOf(acceptedClass);
+		});
+}
+
+const FSlotableActorVisuals* UItemSlot::findVisualsForNetState() const
+{
+	// Prefer the actor's own class, it may have its own entry when child classes are accepted.
+	if (netState.Actor)
+		if (const FSlotableActorVisuals* visuals = findVisualsFor(netState.Actor->GetClass()))
+			return visuals;
+
+	if (!acceptedActors.IsValidIndex(netState.ClassIndex)) { return nullptr; }
+	return findVisualsFor(acceptedActors[netState.ClassIndex]);
+}
+
+FTransform UItemSlot::getVisualsWorldTransform(const FSlotableActorVisuals& visuals) const
+{
+	const FTransform& rootTransform = GetAttachmentRoot()->GetComponentTransform();
+	FVector newPosition = rootTransform.TransformPosition(visuals.RelativePosition);
+	auto newRotation = rootTransform.TransformRotation(FQuat(visuals.RelativeRotation));
+	return FTransform(newRotation, newPosition, visuals.Scale);
+}
+
+void UItemSlot::showPreview(const FSlotableActorVisuals& visualProperties, const EControllerHand handSide)
+{
+	// Not streamed in yet: stay hidden, the subsystem refreshes this slot once the mesh arrives.
+	UItemSlotSubsystem* registry = UItemSlotSubsystem::Get(this);
+	UStaticMesh* mesh = registry ? registry->RequestPreviewMesh(visualProperties.Mesh, this) : visualProperties.Mesh.Get();
+	if (!mesh)
+	{
+		hidePreview();
+		return;
+	}
+
+	if (UItemSlotSettings::Get()->PreviewRendering == EItemSlotPreviewRendering::Instanced)
+	{
+		showInstancedPreview(visualProperties, mesh, handSide);
+		return;
+	}
+
+	if (!visualsComponent && registry)
+		visualsComponent = registry->BorrowPreviewComponent(this);
+
+	if (visualsComponent)
+	{
+		const FTransform previewTransform = getVisualsWorldTransform(visualProperties);
+		visualsComponent->SetWorldLocation(previewTransform.GetLocation());
+		visualsComponent->SetWorldRotation(previewTransform.GetRotation());
+		visualsComponent->SetWorldScale3D(previewTransform.GetScale3D());
+		visualsComponent->SetStaticMesh(mesh);
+
+		if (UMaterialInterface* material = handMaterial(handSide))
+			visualsComponent->SetMaterial(0, material);
+
+		visualsComponent->SetVisibility(true);
+	}
+}
+
+void UItemSlot::showInstancedPreview(const FSlotableActorVisuals& visualProperties, UStaticMesh* mesh, const EControllerHand handSide)
+{
+	UItemSlotSubsystem* registry = UItemSlotSubsystem::Get(this);
+	if (!registry) { return; }
+
+	UMaterialInterface* material = handMaterial(handSide);
+	const FTransform previewTransform = getVisualsWorldTransform(visualProperties);
+
+	// Same batch: only move the instance. Otherwise it changes batch, e.g. on a hand or class change.
+	if (registry->IsPreviewInstanceOf(previewInstance, mesh, material))
+	{
+		registry->UpdatePreviewInstance(previewInstance, previewTransform);
+		return;
+	}
+
+	registry->RemovePreviewInstance(previewInstance);
+	previewInstance = registry->AddPreviewInstance(mesh, material, previewTransform);
+}
+
+void UItemSlot::showProxy(const FSlotableActorVisuals& visualProperties)
+{
+	UItemSlotSubsystem* registry = UItemSlotSubsystem::Get(this);
+	UStaticMesh* mesh = registry ? registry->RequestPreviewMesh(visualProperties.Mesh, this) : nullptr;
+	if (!mesh || visualsComponent)
+		hidePreview();
+	if (!mesh) { return; }
+
+	// Always instanced whatever the preview rendering setting, a slot rack may hold thousands of proxies.
+	showInstancedPreview(visualProperties, mesh, EControllerHand::AnyHand);
+}
+
+UMaterialInterface* UItemSlot::handMaterial(const EControllerHand handSide) const
+{
+	switch (handSide)
+	{
+	case EControllerHand::Left:
+		return leftHandMaterial;
+	case EControllerHand::Right:
+		return rightHandMaterial;
+	default:
+		return nullptr;
+	}
+}
+
+void UItemSlot::hidePreview()
+{
+	if (previewInstance.IsValid())
+		if (UItemSlotSubsystem* registry = UItemSlotSubsystem::Get(this))
+			registry->RemovePreviewInstance(previewInstance);
+
+	if (!visualsComponent) { return; }
+
+	if (UItemSlotSubsystem* registry = UItemSlotSubsystem::Get(this))
+		registry->ReturnPreviewComponent(visualsComponent);
+	else
+		visualsComponent->SetVisibility(false);
+
+	visualsComponent = nullptr;
+}
+
+void UItemSlot::placeOccupant(ASlotableActor* actor)
+{
+	actor->DisableComponentsSimulatePhysics();
+	if (auto castToMesh = Cast<UStaticMeshComponent>(actor->GetRootComponent()))
+		castToMesh->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+
+	// Attachment may already have arrived through actor replication.
+	if (actor->GetRootComponent()->GetAttachParent() == this) { return; }
+
+	actor->AttachToComponent(this, FAttachmentTransformRules::SnapToTargetNotIncludingScale);
+
+	if (const FSlotableActorVisuals* visuals = findVisualsFor(actor->GetClass()))
+	{
+		const FTransform slotTransform = getVisualsWorldTransform(*visuals);
+		actor->SetActorLocationAndRotation(slotTransform.GetLocation(), slotTransform.GetRotation());
+	}
 }
 
 void UItemSlot::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
@@ -566,10 +1015,10 @@ void UItemSlot::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetim
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(UItemSlot, triggerVisuals);
-	DOREPLIFETIME(UItemSlot, currentState);
-	DOREPLIFETIME(UItemSlot, reservedForActor);
-	DOREPLIFETIME(UItemSlot, currentlyDisplayedVisuals);
+	FDoRepLifetimeParams params;
+	params.bIsPushBased = true;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(UItemSlot, netState, params);
 }
 
 
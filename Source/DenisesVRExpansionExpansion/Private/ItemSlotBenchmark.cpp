@@ -0,0 +1,171 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ItemSlotBenchmark.h"
+#include "ItemSlotStats.h"
+#include "ItemSlot.h"
+#include "ItemSlotAllocator.h"
+#include "ItemSlotSubsystem.h"
+#include "ItemSlotReplicationMeasure.h"
+#include "ItemSlotStandaloneWorld.h"
+#include "SlotableActor.h"
+#include "GripMotionControllerComponent.h"
+#include "VRGripInterface.h"
+#include "Components/SphereComponent.h"
+
+namespace
+{
+	struct FBenchmarkGripper
+	{
+		ASlotableActor* Actor = nullptr;
+		UGripMotionControllerComponent* Controller = nullptr;
+		FVector Center;
+		float Radius = 0.0f;
+		float Phase = 0.0f;
+		bool bGripped = false;
+	};
+
+	void gripperGrip(FBenchmarkGripper& gripper)
+	{
+		IVRGripInterface::Execute_OnGrip(gripper.Actor, gripper.Controller, FBPActorGripInformation());
+		gripper.bGripped = true;
+	}
+
+	void gripperRelease(FBenchmarkGripper& gripper)
+	{
+		IVRGripInterface::Execute_OnGripRelease(gripper.Actor, gripper.Controller, FBPActorGripInformation(), false);
+		gripper.bGripped = false;
+	}
+
+	bool isSameNetState(const FItemSlotNetState& a, const FItemSlotNetState& b)
+	{
+		return a.State == b.State && a.HandSide == b.HandSide && a.ClassIndex == b.ClassIndex && a.Actor == b.Actor && a.bProxy == b.bProxy;
+	}
+}
+
+bool FItemSlotBenchmark::Run(const FItemSlotBenchmarkConfig& config, TArray<FItemSlotBenchmarkFrame>& outFrames)
+{
+	const int32 slotNr = FMath::Max(1, config.SlotNr);
+	const int32 gripperNr = FMath::Max(1, config.GripperNr);
+	const int32 frameNr = FMath::Max(1, config.FrameNr);
+	const int32 cycleFrames = FMath::Max(2, config.CycleFrames);
+	const float deltaTime = 1.0f / 90.0f;
+
+	FItemSlotStandaloneWorld benchmarkWorld(TEXT("ItemSlotBenchmark"));
+	UWorld* world = benchmarkWorld.World;
+
+	UItemSlotSubsystem* registry = UItemSlotSubsystem::Get(world);
+	if (!registry)
+	{
+		UE_LOG(LogItemSlots, Error, TEXT("ItemSlotBenchmark: no UItemSlotSubsystem in the benchmark world"));
+		return false;
+	}
+
+	// Slots on a square grid in the XY plane.
+	const int32 rowLength = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(slotNr)));
+	TArray<UItemSlot*> slots;
+	slots.Reserve(slotNr);
+	for (int32 i = 0; i < slotNr; i++)
+	{
+		const FVector location((i % rowLength) * config.SlotSpacing, (i / rowLength) * config.SlotSpacing, 0.0f);
+		AActor* owner = world->SpawnActor<AActor>(AActor::StaticClass(), FTransform(location));
+
+		USceneComponent* root = NewObject<USceneComponent>(owner, TEXT("Root"));
+		owner->SetRootComponent(root);
+		root->RegisterComponent();
+
+		UItemSlot* slot = NewObject<UItemSlot>(owner, TEXT("Slot"));
+		slot->acceptedActors.Add(ASlotableActor::StaticClass());
+		slot->SetUseSpatialRegistryOnly(true);
+		slot->SetupAttachment(root);
+		owner->AddInstanceComponent(slot);
+		// The world has begun play, registering runs the slot's BeginPlay and adds it to the registry.
+		slot->RegisterComponent();
+		slots.Add(slot);
+	}
+
+	// Grippers circle over the slot field, each on its own path.
+	const float fieldSize = rowLength * config.SlotSpacing;
+	TArray<FBenchmarkGripper> grippers;
+	grippers.SetNum(gripperNr);
+	for (int32 i = 0; i < gripperNr; i++)
+	{
+		FBenchmarkGripper& gripper = grippers[i];
+		gripper.Center = FVector(fieldSize * (0.25f + 0.5f * (i % 2)), fieldSize * (0.25f + 0.5f * ((i / 2) % 2)), 0.0f);
+		gripper.Radius = fieldSize * (0.1f + 0.1f * ((i * 7) % 5) / 5.0f);
+		gripper.Phase = i * 0.7f;
+
+		ASlotableActor* actor = world->SpawnActorDeferred<ASlotableActor>(ASlotableActor::StaticClass(), FTransform(gripper.Center));
+		USphereComponent* collider = NewObject<USphereComponent>(actor, TEXT("Collider"));
+		collider->SetSphereRadius(config.ColliderRadius);
+		collider->SetSimulatePhysics(false);
+		actor->SetRootComponent(collider);
+		actor->AddInstanceComponent(collider);
+		actor->FinishSpawning(FTransform(gripper.Center));
+		gripper.Actor = actor;
+
+		AActor* hand = world->SpawnActor<AActor>(AActor::StaticClass(), FTransform(gripper.Center));
+		gripper.Controller = NewObject<UGripMotionControllerComponent>(hand, TEXT("Controller"));
+		gripper.Controller->MotionSource = (i % 2) ? FName(TEXT("right")) : FName(TEXT("left"));
+		hand->SetRootComponent(gripper.Controller);
+		gripper.Controller->RegisterComponent();
+	}
+
+	// Replicated state per slot at the end of the previous frame. Changes within a frame go out as one update.
+	TArray<FItemSlotNetState> sentStates;
+	sentStates.Reserve(slotNr);
+	for (const UItemSlot* slot : slots)
+		sentStates.Add(slot->GetNetState());
+
+	outFrames.Reset();
+	outFrames.SetNumZeroed(frameNr);
+
+	for (int32 frame = 0; frame < frameNr; frame++)
+	{
+		const uint64 rpcsBefore = registry->GetRpcCount();
+		const FItemSlotAllocationScope allocations;
+		const double start = FPlatformTime::Seconds();
+
+		for (int32 i = 0; i < gripperNr; i++)
+		{
+			FBenchmarkGripper& gripper = grippers[i];
+
+			// Staggered so grips and releases are spread over the cycle.
+			const int32 cycleFrame = (frame + i * cycleFrames / gripperNr) % cycleFrames;
+			if (!config.bReleaseGrippers)
+			{
+				if (!gripper.bGripped)
+					gripperGrip(gripper);
+			}
+			else if (cycleFrame == 0 && !gripper.bGripped)
+				gripperGrip(gripper);
+			else if (cycleFrame == cycleFrames - 1 && gripper.bGripped)
+				gripperRelease(gripper);
+
+			if (!gripper.bGripped) { continue; }
+
+			const float angle = gripper.Phase + frame * deltaTime * 2.0f;
+			const FVector location = gripper.Center + FVector(FMath::Cos(angle), FMath::Sin(angle), 0.0f) * gripper.Radius;
+			gripper.Actor->SetActorLocation(location);
+		}
+
+		benchmarkWorld.Tick(deltaTime);
+
+		FItemSlotBenchmarkFrame& result = outFrames[frame];
+		result.FrameMs = (FPlatformTime::Seconds() - start) * 1000.0;
+		result.SlotMs = registry->GetLastTickMs();
+		result.Allocations = allocations.Num();
+		result.Rpcs = registry->GetRpcCount() - rpcsBefore;
+
+		int64 bits = 0;
+		for (int32 i = 0; i < slotNr; i++)
+		{
+			if (isSameNetState(slots[i]->GetNetState(), sentStates[i])) { continue; }
+
+			sentStates[i] = slots[i]->GetNetState();
+			bits += FItemSlotReplicationMeasure::MeasureSlotStateBits(slots[i]);
+			result.DirtySlots++;
+		}
+		result.Bytes = (bits + 7) / 8;
+	}
+	return true;
+}
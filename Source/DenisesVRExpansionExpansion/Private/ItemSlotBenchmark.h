@@ -0,0 +1,45 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FItemSlotBenchmarkConfig
+{
+	int32 SlotNr = 1000;
+	int32 GripperNr = 8;
+	int32 FrameNr = 600;
+	//	Frames between a gripper's grips, it is released on the last one so it gets slotted.
+	int32 CycleFrames = 90;
+	//	False for a grip sweep: every gripper grips on the first frame and keeps moving without being released.
+	bool bReleaseGrippers = true;
+	float SlotSpacing = 40.0f;
+	float ColliderRadius = 30.0f;
+};
+
+struct FItemSlotBenchmarkFrame
+{
+	//	The whole world tick, and the UItemSlotSubsystem tick within it.
+	double FrameMs = 0.0;
+	double SlotMs = 0.0;
+	//	Calls of UItemSlot's server RPCs.
+	uint64 Rpcs = 0;
+	//	Slots whose replicated state differs from the previous frame, and the measured size of their new states.
+	int32 DirtySlots = 0;
+	int64 Bytes = 0;
+	//	Heap allocations of slot containers, see FItemSlotAllocationScope.
+	uint64 Allocations = 0;
+};
+
+/**
+ * Headless slot reservation and insertion benchmark, shared by the ItemSlotBenchmark commandlet and the automation tests.
+ * Spawns a grid of registry-only UItemSlots and simulated grippers in a standalone world (no motion controllers are tracked,
+ * OnGrip / OnGripRelease are driven directly), moves the grippers along scripted circles and releases / re-grips them
+ * periodically so they get slotted and pulled out again. The world is ticked as a whole every frame.
+ * Grippers take one lap of their circle every 283 frames (2 rad/s at 90 fps).
+ */
+struct FItemSlotBenchmark
+{
+	//	Fills one entry per frame. False when the world couldn't be set up.
+	static bool Run(const FItemSlotBenchmarkConfig& config, TArray<FItemSlotBenchmarkFrame>& outFrames);
+};
@@ -0,0 +1,102 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ItemSlotBenchmarkCommandlet.h"
+#include "ItemSlotBenchmark.h"
+#include "ItemSlotStats.h"
+#include "ItemSlotReplicationMeasure.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+UItemSlotBenchmarkCommandlet::UItemSlotBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = true;
+	LogToConsole = true;
+}
+
+namespace
+{
+	int32 getIntParam(const TMap<FString, FString>& params, const TCHAR* name, int32 defaultValue)
+	{
+		const FString* value = params.Find(name);
+		return value ? FCString::Atoi(**value) : defaultValue;
+	}
+
+	//	Negative when the threshold wasn't provided.
+	double getThreshold(const TMap<FString, FString>& params, const TCHAR* name)
+	{
+		const FString* value = params.Find(name);
+		return value ? FCString::Atod(**value) : -1.0;
+	}
+
+	bool checkThreshold(const TCHAR* name, double average, double threshold)
+	{
+		if (threshold < 0.0 || average <= threshold) { return true; }
+
+		UE_LOG(LogItemSlots, Error, TEXT("ItemSlotBenchmark: %s average %.4f exceeds threshold %.4f"), name, average, threshold);
+		return false;
+	}
+}
+
+int32 UItemSlotBenchmarkCommandlet::Main(const FString& Params)
+{
+	TArray<FString> tokens;
+	TArray<FString> switches;
+	TMap<FString, FString> params;
+	ParseCommandLine(*Params, tokens, switches, params);
+
+	FItemSlotBenchmarkConfig config;
+	config.SlotNr = getIntParam(params, TEXT("Slots"), config.SlotNr);
+	config.GripperNr = getIntParam(params, TEXT("Grippers"), config.GripperNr);
+	config.FrameNr = FMath::Max(1, getIntParam(params, TEXT("Frames"), config.FrameNr));
+	config.CycleFrames = getIntParam(params, TEXT("CycleFrames"), config.CycleFrames);
+	const int32 warmupNr = FMath::Clamp(getIntParam(params, TEXT("Warmup"), 60), 0, config.FrameNr - 1);
+	FString csvPath = params.FindRef(TEXT("Csv"));
+	if (csvPath.IsEmpty())
+		csvPath = FPaths::Combine(FPaths::ProfilingDir(), TEXT("ItemSlotBenchmark.csv"));
+
+	TArray<FItemSlotBenchmarkFrame> frames;
+	if (!FItemSlotBenchmark::Run(config, frames)) { return 1; }
+
+	// Report
+	FString csv = TEXT("Frame,FrameMs,SlotMs,Rpcs,DirtySlots,ReplicatedBytes,Allocations\n");
+	double totalFrameMs = 0.0;
+	double totalSlotMs = 0.0;
+	double totalRpcs = 0.0;
+	double totalBytes = 0.0;
+	double totalAllocations = 0.0;
+	for (int32 frame = 0; frame < frames.Num(); frame++)
+	{
+		const FItemSlotBenchmarkFrame& result = frames[frame];
+		csv += FString::Printf(TEXT("%d,%.4f,%.4f,%llu,%d,%lld,%llu\n"), frame, result.FrameMs, result.SlotMs, result.Rpcs, result.DirtySlots, result.Bytes, result.Allocations);
+
+		if (frame < warmupNr) { continue; }
+		totalFrameMs += result.FrameMs;
+		totalSlotMs += result.SlotMs;
+		totalRpcs += result.Rpcs;
+		totalBytes += result.Bytes;
+		totalAllocations += result.Allocations;
+	}
+
+	if (!FFileHelper::SaveStringToFile(csv, *csvPath))
+		UE_LOG(LogItemSlots, Error, TEXT("ItemSlotBenchmark: could not write %s"), *csvPath);
+
+	const double measuredNr = frames.Num() - warmupNr;
+	const double averageFrameMs = totalFrameMs / measuredNr;
+	const double averageSlotMs = totalSlotMs / measuredNr;
+	const double averageRpcs = totalRpcs / measuredNr;
+	const double averageBytes = totalBytes / measuredNr;
+	const double averageAllocations = totalAllocations / measuredNr;
+
+	UE_LOG(LogItemSlots, Display, TEXT("ItemSlotBenchmark: %d slots, %d grippers, %d frames (%d warmup). Per frame: %.4f ms (%.4f ms in slot code), %.2f RPCs, %.1f replicated bytes, %.2f allocations. CSV: %s"),
+		config.SlotNr, config.GripperNr, frames.Num(), warmupNr, averageFrameMs, averageSlotMs, averageRpcs, averageBytes, averageAllocations, *csvPath);
+
+	bool passed = true;
+	passed &= checkThreshold(TEXT("SlotMs"), averageSlotMs, getThreshold(params, TEXT("MaxSlotMs")));
+	passed &= checkThreshold(TEXT("Rpcs"), averageRpcs, getThreshold(params, TEXT("MaxRpcsPerFrame")));
+	passed &= checkThreshold(TEXT("ReplicatedBytes"), averageBytes, getThreshold(params, TEXT("MaxBytesPerFrame")));
+	passed &= checkThreshold(TEXT("Allocations"), averageAllocations, getThreshold(params, TEXT("MaxAllocsPerFrame")));
+
+	return passed ? 0 : 1;
+}
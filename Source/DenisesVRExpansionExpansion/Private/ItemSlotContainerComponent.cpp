@@ -0,0 +1,118 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ItemSlotContainerComponent.h"
+#include "ItemSlot.h"
+#include "ItemSlotSubsystem.h"
+#include "SlotableActor.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+
+UItemSlotContainerComponent::UItemSlotContainerComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+	bWantsInitializeComponent = true;
+	SetIsReplicatedByDefault(true);
+}
+
+void UItemSlotContainerComponent::InitializeComponent()
+{
+	Super::InitializeComponent();
+
+	AActor* owner = GetOwner();
+	slots.SetNum(Entries.Num());
+
+	for (int32 i = 0; i < Entries.Num(); i++)
+	{
+		const FItemSlotContainerEntry& entry = Entries[i];
+
+		// Created the same way with the same name on every machine, so clients can resolve the server's slot by name.
+		const FName slotName(*FString::Printf(TEXT("%s_Slot%d"), *GetName(), i));
+		UItemSlot* slot = NewObject<UItemSlot>(owner, slotName);
+		slot->SetNetAddressable();
+		slot->SetupAttachment(this);
+		slot->SetRelativeTransform(entry.RelativeTransform);
+		slot->initContainerSlot(entry, *this, i);
+
+		owner->AddInstanceComponent(slot);
+		slot->RegisterComponent();
+		slots[i].Slot = slot;
+	}
+
+	// A state that replicated before the slots existed.
+	OnRep_Slots();
+}
+
+void UItemSlotContainerComponent::UninitializeComponent()
+{
+	for (FItemSlotContainerSlot& entrySlot : slots)
+	{
+		if (IsValid(entrySlot.Slot))
+			entrySlot.Slot->DestroyComponent();
+	}
+	slots.Reset();
+
+	Super::UninitializeComponent();
+}
+
+UItemSlot* UItemSlotContainerComponent::FindSlot(FName entryName) const
+{
+	const int32 index = Entries.IndexOfByPredicate([&](const FItemSlotContainerEntry& entry) { return entry.Name == entryName; });
+	return GetSlot(index);
+}
+
+FTransform UItemSlotContainerComponent::GetEntryWorldTransform(int32 entryIndex) const
+{
+	if (!Entries.IsValidIndex(entryIndex)) { return GetComponentTransform(); }
+
+	return Entries[entryIndex].RelativeTransform * GetComponentTransform();
+}
+
+int32 UItemSlotContainerComponent::ApplyLoadout(const TMap<FName, TSubclassOf<ASlotableActor>>& EntryClasses)
+{
+	UItemSlotSubsystem* registry = UItemSlotSubsystem::Get(this);
+	if (!registry) { return 0; }
+
+	TArray<FItemSlotLoadoutEntry> loadout;
+	loadout.Reserve(EntryClasses.Num());
+	for (const TPair<FName, TSubclassOf<ASlotableActor>>& pair : EntryClasses)
+	{
+		FItemSlotLoadoutEntry& entry = loadout.AddDefaulted_GetRef();
+		entry.Slot = FindSlot(pair.Key);
+		entry.ActorClass = pair.Value;
+	}
+
+	TArray<EItemSlotLoadoutResult> results;
+	return registry->ApplyLoadout(loadout, results);
+}
+
+void UItemSlotContainerComponent::onSlotStateCommitted(int32 entryIndex, const FItemSlotNetState& state)
+{
+	if (!slots.IsValidIndex(entryIndex)) { return; }
+
+	slots[entryIndex].NetState = state;
+	MARK_PROPERTY_DIRTY_FROM_NAME(UItemSlotContainerComponent, slots, this);
+}
+
+void UItemSlotContainerComponent::OnRep_Slots()
+{
+	// Same as UItemSlot::OnRep_NetState, for every entry whose state changed.
+	for (FItemSlotContainerSlot& entrySlot : slots)
+	{
+		UItemSlot* slot = entrySlot.Slot;
+		if (!slot || slot->netState == entrySlot.NetState) { continue; }
+
+		const FItemSlotNetState previousState = slot->netState;
+		slot->netState = entrySlot.NetState;
+		slot->applyNetState(previousState);
+	}
+}
+
+void UItemSlotContainerComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	FDoRepLifetimeParams params;
+	params.bIsPushBased = true;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(UItemSlotContainerComponent, slots, params);
+}
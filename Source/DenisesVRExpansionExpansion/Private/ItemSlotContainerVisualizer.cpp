@@ -0,0 +1,24 @@
+#if WITH_EDITOR
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ItemSlotContainerVisualizer.h"
+#include "ItemSlotContainerComponent.h"
+#include "SceneManagement.h"
+
+void FItemSlotContainerVisualizer::DrawVisualization(const UActorComponent* Component, const FSceneView* View, FPrimitiveDrawInterface* PDI)
+{
+	const UItemSlotContainerComponent* container = Cast<UItemSlotContainerComponent>(Component);
+	if (!container) { return; }
+
+	for (int32 i = 0; i < container->Entries.Num(); i++)
+	{
+		const FItemSlotContainerEntry& entry = container->Entries[i];
+		const FTransform slotTransform = container->GetEntryWorldTransform(i);
+
+		// Entries nothing fits in are drawn red, they can't receive anything.
+		const FLinearColor color = entry.AcceptedActors.Num() > 0 ? FLinearColor(0.2f, 0.8f, 1.0f) : FLinearColor::Red;
+		DrawWireSphere(PDI, slotTransform.GetLocation(), color, entry.TriggerRadius, 16, SDPG_World);
+		DrawCoordinateSystem(PDI, slotTransform.GetLocation(), slotTransform.Rotator(), entry.TriggerRadius * 0.5f, SDPG_World);
+	}
+}
+#endif
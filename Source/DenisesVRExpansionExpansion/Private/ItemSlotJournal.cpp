@@ -0,0 +1,170 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ItemSlotJournal.h"
+#include "ItemSlotStats.h"
+#include "ItemSlot.h"
+#include "ItemSlotSubsystem.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "Serialization/Archive.h"
+
+namespace
+{
+	const uint32 JournalMagic = 0x4A535644;	// "DVSJ"
+	const uint32 JournalVersion = 3;
+}
+
+void FItemSlotJournal::SetCapacity(int32 capacity)
+{
+	Reset();
+	entries.SetNumZeroed(FMath::Max(0, capacity));
+}
+
+void FItemSlotJournal::Reset()
+{
+	head = 0;
+	entryNr = 0;
+	objects.Empty();
+	objectRefs.Empty();
+	objectKeys.Empty();
+	freeObjectIds.Empty();
+	objectIds.Empty();
+}
+
+void FItemSlotJournal::Record(const UItemSlot* slot, const FItemSlotNetState& from, const FItemSlotNetState& to, uint8 event, double time, uint32 frame)
+{
+	if (entries.Num() == 0) { return; }
+
+	FItemSlotJournalEntry& entry = entries[head];
+
+	// The entry about to be overwritten leaves the ring.
+	if (entryNr == entries.Num())
+	{
+		releaseObjectId(entry.SlotId);
+		releaseObjectId(entry.ActorId);
+	}
+
+	entry.Time = time;
+	entry.Frame = frame;
+	entry.SlotId = acquireObjectId(slot);
+	entry.ActorId = acquireObjectId(to.Actor ? to.Actor.Get() : from.Actor.Get());
+	entry.FromState = from.State;
+	entry.ToState = to.State;
+	entry.HandSide = static_cast<uint8>(to.HandSide);
+	entry.ClassIndex = to.ClassIndex;
+	entry.Event = event;
+	entry.bFromProxy = from.bProxy;
+	entry.bToProxy = to.bProxy;
+
+	head = (head + 1) % entries.Num();
+	entryNr = FMath::Min(entryNr + 1, entries.Num());
+}
+
+void FItemSlotJournal::GetEntries(TArray<FItemSlotJournalEntry>& outEntries) const
+{
+	outEntries.Reset(entryNr);
+
+	// Before the first wrap the oldest entry is at 0, afterwards it is the one about to be overwritten.
+	const int32 first = entryNr < entries.Num() ? 0 : head;
+	for (int32 i = 0; i < entryNr; i++)
+		outEntries.Add(entries[(first + i) % entries.Num()]);
+}
+
+uint32 FItemSlotJournal::acquireObjectId(const UObject* object)
+{
+	if (!object) { return 0; }
+
+	if (const uint32* id = objectIds.Find(object))
+	{
+		objectRefs[*id - 1]++;
+		return *id;
+	}
+
+	uint32 id;
+	if (freeObjectIds.Num() > 0)
+		id = freeObjectIds.Pop(false);
+	else
+	{
+		objects.AddDefaulted();
+		objectRefs.Add(0);
+		objectKeys.AddDefaulted();
+		id = objects.Num();
+	}
+
+	FItemSlotJournalObject& entry = objects[id - 1];
+	entry.Path = object->GetPathName();
+	entry.ClassPath = object->GetClass()->GetPathName();
+	objectRefs[id - 1] = 1;
+	objectKeys[id - 1] = object;
+	objectIds.Add(object, id);
+	return id;
+}
+
+void FItemSlotJournal::releaseObjectId(uint32 id)
+{
+	if (id == 0 || !objectRefs.IsValidIndex(id - 1) || --objectRefs[id - 1] > 0) { return; }
+
+	objectIds.Remove(objectKeys[id - 1]);
+	objectKeys[id - 1] = FObjectKey();
+	objects[id - 1] = FItemSlotJournalObject();
+	freeObjectIds.Add(id);
+}
+
+bool FItemSlotJournal::SaveToFile(const FString& path) const
+{
+	TUniquePtr<FArchive> writer(IFileManager::Get().CreateFileWriter(*path));
+	if (!writer) { return false; }
+
+	uint32 magic = JournalMagic;
+	uint32 version = JournalVersion;
+	*writer << magic << version;
+
+	TArray<FItemSlotJournalObject> objectTable = objects;
+	*writer << objectTable;
+
+	TArray<FItemSlotJournalEntry> orderedEntries;
+	GetEntries(orderedEntries);
+	*writer << orderedEntries;
+
+	return writer->Close();
+}
+
+bool FItemSlotJournal::LoadFromFile(const FString& path)
+{
+	TUniquePtr<FArchive> reader(IFileManager::Get().CreateFileReader(*path));
+	if (!reader) { return false; }
+
+	uint32 magic = 0;
+	uint32 version = 0;
+	*reader << magic << version;
+	if (magic != JournalMagic || version != JournalVersion)
+	{
+		UE_LOG(LogItemSlots, Error, TEXT("%s is not an item slot journal of version %u"), *path, JournalVersion);
+		return false;
+	}
+
+	Reset();
+	*reader << objects;
+	*reader << entries;
+	entryNr = entries.Num();
+	head = 0;
+
+	return !reader->IsError();
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GItemSlotDumpJournalCommand(
+	TEXT("DVREE.Slots.DumpJournal"),
+	TEXT("Writes the server's slot transition journal to disk. Optional argument: file path, defaults to Saved/Logs/ItemSlotJournal.bin."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& args, UWorld* world)
+		{
+			UItemSlotSubsystem* registry = UItemSlotSubsystem::Get(world);
+			if (!registry) { return; }
+
+			const FString path = args.Num() > 0 ? args[0] : FPaths::Combine(FPaths::ProjectLogDir(), TEXT("ItemSlotJournal.bin"));
+			const FItemSlotJournal& journal = registry->GetJournal();
+			if (journal.SaveToFile(path))
+				UE_LOG(LogItemSlots, Log, TEXT("Wrote %d slot transition(s) to %s"), journal.Num(), *path);
+			else
+				UE_LOG(LogItemSlots, Error, TEXT("Could not write the slot journal to %s"), *path);
+		}));
@@ -0,0 +1,74 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ItemSlotLayout.h"
+#include "SlotableActor.h"
+#include "Algo/BinarySearch.h"
+
+void UItemSlotLayout::PostLoad()
+{
+	Super::PostLoad();
+
+	// Class pointers are only stable for the lifetime of the process, so the order is rebuilt on load.
+	sortEntries();
+}
+
+#if WITH_EDITOR
+void UItemSlotLayout::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	sortEntries();
+}
+#endif
+
+const FSlotableActorVisuals* UItemSlotLayout::FindVisuals(const UClass* actorClass) const
+{
+	const int32 index = Algo::BinarySearchBy(entries, actorClass, [](const FItemSlotLayoutEntry& entry) -> const UClass*
+		{
+			return entry.ActorClass.Get();
+		});
+
+	return index != INDEX_NONE ? &entries[index].Visuals : nullptr;
+}
+
+void UItemSlotLayout::SetVisuals(TSubclassOf<ASlotableActor> actorClass, const FSlotableActorVisuals& visuals)
+{
+	for (FItemSlotLayoutEntry& entry : entries)
+	{
+		if (entry.ActorClass == actorClass)
+		{
+			entry.Visuals = visuals;
+			return;
+		}
+	}
+
+	FItemSlotLayoutEntry& newEntry = entries.AddDefaulted_GetRef();
+	newEntry.ActorClass = actorClass;
+	newEntry.Visuals = visuals;
+	sortEntries();
+}
+
+#if WITH_EDITOR
+FSlotableActorVisuals* UItemSlotLayout::E_EditVisuals(const UClass* actorClass)
+{
+	if (!FindVisuals(actorClass)) { return nullptr; }
+
+	Modify();
+	return const_cast<FSlotableActorVisuals*>(FindVisuals(actorClass));
+}
+#endif
+
+SIZE_T UItemSlotLayout::GetEntriesAllocatedSize() const
+{
+	SIZE_T size = entries.GetAllocatedSize();
+	for (const FItemSlotLayoutEntry& entry : entries)
+		size += entry.Visuals.ID.GetAllocatedSize();
+	return size;
+}
+
+void UItemSlotLayout::sortEntries()
+{
+	entries.Sort([](const FItemSlotLayoutEntry& a, const FItemSlotLayoutEntry& b)
+		{
+			return a.ActorClass.Get() < b.ActorClass.Get();
+		});
+}
@@ -0,0 +1,196 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ItemSlotLayoutCommandlet.h"
+#include "ItemSlotStats.h"
+#include "ItemSlot.h"
+#include "ItemSlotLayout.h"
+#include "SlotableActor.h"
+
+#if WITH_EDITOR
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Engine/Blueprint.h"
+#include "Engine/World.h"
+#include "FileHelpers.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectHash.h"
+#endif
+
+UItemSlotLayoutCommandlet::UItemSlotLayoutCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+#if WITH_EDITOR
+namespace
+{
+	using FInlineVisualsMap = TMap<TSubclassOf<ASlotableActor>, FSlotableActorVisuals>;
+
+	struct FLayoutGroup
+	{
+		FInlineVisualsMap Visuals;
+		TArray<UItemSlot*> Slots;
+	};
+
+	// Two maps with the same key describe the same layout.
+	FString makeLayoutKey(const FInlineVisualsMap& visualsMap)
+	{
+		TArray<FString> lines;
+		for (const auto& pair : visualsMap)
+		{
+			const FSlotableActorVisuals& visuals = pair.Value;
+			lines.Add(FString::Printf(TEXT("%s|%s|%s|%s|%s|%s"),
+				*GetPathNameSafe(pair.Key.Get()),
+				*visuals.ID,
+				*visuals.Mesh.ToString(),
+				*visuals.Scale.ToString(),
+				*visuals.RelativePosition.ToString(),
+				*visuals.RelativeRotation.ToString()));
+		}
+		lines.Sort();
+		return FString::Join(lines, TEXT("\n"));
+	}
+
+	// Next ItemSlotLayout_<n> that is neither loaded nor on disk under outputPath.
+	FString makeUniqueLayoutName(const FString& outputPath, int32& nextIndex)
+	{
+		FString assetName;
+		do
+		{
+			assetName = FString::Printf(TEXT("ItemSlotLayout_%d"), nextIndex++);
+		} while (FindPackage(nullptr, *(outputPath / assetName)) || FPackageName::DoesPackageExist(outputPath / assetName));
+
+		return assetName;
+	}
+
+	SIZE_T getInlineAllocatedSize(const FInlineVisualsMap& visualsMap)
+	{
+		SIZE_T size = visualsMap.GetAllocatedSize();
+		for (const auto& pair : visualsMap)
+			size += pair.Value.ID.GetAllocatedSize();
+		return size;
+	}
+}
+#endif
+
+int32 UItemSlotLayoutCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	TArray<FString> tokens;
+	TArray<FString> switches;
+	TMap<FString, FString> params;
+	ParseCommandLine(*Params, tokens, switches, params);
+
+	const bool apply = switches.Contains(TEXT("Apply"));
+	const int32 minInstances = FMath::Max(2, FCString::Atoi(*params.FindRef(TEXT("MinInstances"))));
+	FString outputPath = params.FindRef(TEXT("OutputPath"));
+	if (outputPath.IsEmpty())
+		outputPath = TEXT("/Game/ItemSlotLayouts");
+
+	TArray<FString> packageNames;
+	params.FindRef(TEXT("Packages")).ParseIntoArray(packageNames, TEXT("+"));
+
+	if (packageNames.Num() == 0)
+	{
+		IAssetRegistry& assetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+		assetRegistry.SearchAllAssets(true);
+
+		FARFilter filter;
+		filter.PackagePaths.Add(TEXT("/Game"));
+		filter.bRecursivePaths = true;
+		filter.ClassPaths.Add(UWorld::StaticClass()->GetClassPathName());
+		filter.ClassPaths.Add(UBlueprint::StaticClass()->GetClassPathName());
+		filter.bRecursiveClasses = true;
+
+		TArray<FAssetData> assets;
+		assetRegistry.GetAssets(filter, assets);
+		for (const FAssetData& asset : assets)
+			packageNames.AddUnique(asset.PackageName.ToString());
+	}
+
+	TMap<FString, FLayoutGroup> groups;
+	int32 slotNr = 0;
+
+	for (const FString& packageName : packageNames)
+	{
+		UPackage* package = LoadPackage(nullptr, *packageName, LOAD_None);
+		if (!package)
+		{
+			UE_LOG(LogItemSlots, Warning, TEXT("Could not load '%s'"), *packageName);
+			continue;
+		}
+
+		ForEachObjectWithPackage(package, [&groups, &slotNr](UObject* object)
+			{
+				UItemSlot* slot = Cast<UItemSlot>(object);
+				if (!slot || slot->E_GetInlineVisuals().Num() == 0) { return true; }
+
+				FLayoutGroup& group = groups.FindOrAdd(makeLayoutKey(slot->E_GetInlineVisuals()));
+				if (group.Slots.Num() == 0)
+					group.Visuals = slot->E_GetInlineVisuals();
+				group.Slots.Add(slot);
+				slotNr++;
+				return true;
+			});
+	}
+
+	SIZE_T inlineBytes = 0;
+	SIZE_T sharedBytes = 0;
+	int32 layoutNr = 0;
+	TArray<UPackage*> packagesToSave;
+	int32 nextLayoutIndex = 0;
+
+	for (auto& pair : groups)
+	{
+		FLayoutGroup& group = pair.Value;
+		const SIZE_T mapBytes = getInlineAllocatedSize(group.Visuals);
+		inlineBytes += mapBytes * group.Slots.Num();
+
+		if (group.Slots.Num() < minInstances)
+		{
+			sharedBytes += mapBytes * group.Slots.Num();
+			continue;
+		}
+
+		sharedBytes += mapBytes;
+		layoutNr++;
+		if (!apply) { continue; }
+
+		const FString assetName = makeUniqueLayoutName(outputPath, nextLayoutIndex);
+		UPackage* layoutPackage = CreatePackage(*(outputPath / assetName));
+		UItemSlotLayout* layout = NewObject<UItemSlotLayout>(layoutPackage, *assetName, RF_Public | RF_Standalone);
+		for (const auto& visualsPair : group.Visuals)
+			layout->SetVisuals(visualsPair.Key, visualsPair.Value);
+
+		FAssetRegistryModule::AssetCreated(layout);
+		layoutPackage->MarkPackageDirty();
+		packagesToSave.AddUnique(layoutPackage);
+
+		for (UItemSlot* slot : group.Slots)
+		{
+			slot->E_UseLayout(layout);
+			slot->MarkPackageDirty();
+			packagesToSave.AddUnique(slot->GetOutermost());
+		}
+	}
+
+	UE_LOG(LogItemSlots, Display, TEXT("Scanned %d package(s): %d slot(s) with inline visuals in %d distinct layout(s)."), packageNames.Num(), slotNr, groups.Num());
+	UE_LOG(LogItemSlots, Display, TEXT("%d layout(s) shared by at least %d slots. Inline visuals: %llu bytes, with shared layouts: %llu bytes, saved: %llu bytes."),
+		layoutNr, minInstances, (uint64)inlineBytes, (uint64)sharedBytes, (uint64)(inlineBytes - sharedBytes));
+
+	if (apply && packagesToSave.Num() > 0)
+	{
+		if (!UEditorLoadingAndSavingUtils::SavePackages(packagesToSave, false))
+		{
+			UE_LOG(LogItemSlots, Error, TEXT("Saving converted packages failed."));
+			return 1;
+		}
+	}
+	return 0;
+#else
+	return 1;
+#endif
+}
@@ -0,0 +1,144 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ItemSlotNetObjectFilter.h"
+#include "ItemSlotStats.h"
+#include "ItemSlotSettings.h"
+#include "ItemSlotReplicationGraph.h"
+#include "SlotableActor.h"
+#include "Iris/ReplicationSystem/ReplicationSystem.h"
+#include "Net/Iris/ReplicationSystem/ReplicationSystemUtil.h"
+
+const FName UItemSlotNetObjectFilter::FilterName(TEXT("ItemSlotOwners"));
+
+bool UItemSlotNetObjectFilter::AddActor(AActor* actor, bool& outRetry)
+{
+	outRetry = false;
+	if (!actor || !actor->GetIsReplicated()) { return false; }
+
+	UReplicationSystem* replicationSystem = UE::Net::FReplicationSystemUtil::GetReplicationSystem(actor);
+	UItemSlotNetObjectFilter* filter = replicationSystem ? Cast<UItemSlotNetObjectFilter>(replicationSystem->GetFilter(FilterName)) : nullptr;
+	if (!filter) { return false; }
+
+	// The handle is created when the actor begins replicating, which may be after its slots registered.
+	const UE::Net::FNetRefHandle handle = UE::Net::FReplicationSystemUtil::GetNetRefHandle(actor);
+	if (!handle.IsValid())
+	{
+		outRetry = true;
+		return false;
+	}
+
+	const uint32 objectIndex = filter->GetObjectIndex(handle);
+	if (filter->owners.Contains(objectIndex)) { return true; }
+
+	FOwner& owner = filter->owners.Add(objectIndex);
+	owner.Actor = actor;
+	owner.bMovable = actor->GetRootComponent() && actor->GetRootComponent()->Mobility == EComponentMobility::Movable;
+
+	replicationSystem->SetFilter(handle, replicationSystem->GetFilterHandle(FilterName));
+	return true;
+}
+
+FIntVector UItemSlotNetObjectFilter::toCell(const FVector& location) const
+{
+	const float cellSize = UItemSlotSettings::Get()->SlotReplicationCellSize;
+	return FIntVector(
+		FMath::FloorToInt(location.X / cellSize),
+		FMath::FloorToInt(location.Y / cellSize),
+		FMath::FloorToInt(location.Z / cellSize));
+}
+
+void UItemSlotNetObjectFilter::removeFromCell(const FIntVector& cell, uint32 objectIndex)
+{
+	TArray<uint32>* list = cells.Find(cell);
+	if (!list) { return; }
+
+	list->RemoveSingleSwap(objectIndex);
+	if (list->Num() == 0)
+		cells.Remove(cell);
+}
+
+void UItemSlotNetObjectFilter::OnInit(FNetObjectFilterInitParams& Params)
+{
+	owners.Reset();
+	cells.Reset();
+}
+
+bool UItemSlotNetObjectFilter::AddObject(uint32 ObjectIndex, FNetObjectFilterAddObjectParams& Params)
+{
+	// Objects assigned to the filter by anything but AddActor are left to the default filtering.
+	FOwner* owner = owners.Find(ObjectIndex);
+	const AActor* actor = owner ? owner->Actor.Get() : nullptr;
+	if (!actor) { return false; }
+
+	owner->Center = UReplicationGraphNode_ItemSlots::SlotCenter(actor);
+	owner->Cell = toCell(owner->Center);
+	cells.FindOrAdd(owner->Cell).Add(ObjectIndex);
+	return true;
+}
+
+void UItemSlotNetObjectFilter::RemoveObject(uint32 ObjectIndex, const FNetObjectFilteringInfo& Info)
+{
+	FOwner owner;
+	if (!owners.RemoveAndCopyValue(ObjectIndex, owner)) { return; }
+
+	removeFromCell(owner.Cell, ObjectIndex);
+}
+
+void UItemSlotNetObjectFilter::PreFilter(FNetObjectPreFilteringParams& Params)
+{
+	ITEMSLOTS_SCOPE(RepGraphPrepare);
+
+	// Once per frame for all connections. Only movable owners and slotable actors can change cell.
+	for (TPair<uint32, FOwner>& entry : owners)
+	{
+		FOwner& owner = entry.Value;
+		const AActor* actor = owner.Actor.Get();
+		const ASlotableActor* slotableActor = Cast<ASlotableActor>(actor);
+		owner.bPooled = slotableActor && slotableActor->IsPooled();
+		if (!owner.bMovable || !actor) { continue; }
+
+		owner.Center = UReplicationGraphNode_ItemSlots::SlotCenter(actor);
+		const FIntVector cell = toCell(owner.Center);
+		if (cell == owner.Cell) { continue; }
+
+		removeFromCell(owner.Cell, entry.Key);
+		owner.Cell = cell;
+		cells.FindOrAdd(cell).Add(entry.Key);
+	}
+}
+
+void UItemSlotNetObjectFilter::Filter(FNetObjectFilteringParams& Params)
+{
+	ITEMSLOTS_SCOPE(RepGraphGather);
+
+	const UItemSlotSettings* settings = UItemSlotSettings::Get();
+	const float relevancyRadius = settings->SlotRelevancyRadius;
+	const float relevancyRadiusSquared = FMath::Square(relevancyRadius);
+
+	// Only the cells in reach of a view are visited, objects of the filter that aren't set here are not replicated.
+	int32 allowedNr = 0;
+	for (const UE::Net::FReplicationView::FView& view : Params.View.Views)
+	{
+		const FIntVector minCell = toCell(view.Pos - FVector(relevancyRadius));
+		const FIntVector maxCell = toCell(view.Pos + FVector(relevancyRadius));
+
+		for (int32 x = minCell.X; x <= maxCell.X; x++)
+		for (int32 y = minCell.Y; y <= maxCell.Y; y++)
+		for (int32 z = minCell.Z; z <= maxCell.Z; z++)
+		{
+			const TArray<uint32>* list = cells.Find(FIntVector(x, y, z));
+			if (!list) { continue; }
+
+			for (const uint32 objectIndex : *list)
+			{
+				const FOwner& owner = owners[objectIndex];
+				if (owner.bPooled || FVector::DistSquared(owner.Center, view.Pos) > relevancyRadiusSquared) { continue; }
+
+				Params.OutAllowedObjects.SetBit(objectIndex);
+				allowedNr++;
+			}
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_ItemSlots_RepGraphGathered, allowedNr);
+}
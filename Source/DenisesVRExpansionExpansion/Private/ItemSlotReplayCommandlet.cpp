@@ -0,0 +1,201 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ItemSlotReplayCommandlet.h"
+#include "ItemSlotStats.h"
+#include "ItemSlot.h"
+#include "ItemSlotJournal.h"
+#include "ItemSlotSubsystem.h"
+#include "SlotableActor.h"
+#include "Components/SphereComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+UItemSlotReplayCommandlet::UItemSlotReplayCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = true;
+	LogToConsole = true;
+}
+
+namespace
+{
+	const TCHAR* stateName(uint8 state)
+	{
+		switch (state)
+		{
+		case EItemSlotState::available:	return TEXT("available");
+		case EItemSlotState::reserved:	return TEXT("reserved");
+		case EItemSlotState::occupied:	return TEXT("occupied");
+		default:						return TEXT("unknown");
+		}
+	}
+
+	const TCHAR* eventName(uint8 event)
+	{
+		return event == FItemSlotJournalEntry::DirectCommit ? TEXT("DirectCommit") : ItemSlotStateMachine::EventName(static_cast<EItemSlotEvent>(event));
+	}
+
+	//	Events that leave their instigating actor in the slot's replicated state.
+	bool keepsActor(uint8 event)
+	{
+		switch (static_cast<EItemSlotEvent>(event))
+		{
+		case EItemSlotEvent::Reserve:
+		case EItemSlotEvent::Receive:
+		case EItemSlotEvent::Insert:
+		case EItemSlotEvent::Rehydrate:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	UClass* loadActorClass(const FItemSlotJournalObject* object)
+	{
+		UClass* actorClass = object ? LoadObject<UClass>(nullptr, *object->ClassPath) : nullptr;
+		return actorClass && actorClass->IsChildOf(ASlotableActor::StaticClass()) ? actorClass : ASlotableActor::StaticClass();
+	}
+}
+
+int32 UItemSlotReplayCommandlet::Main(const FString& Params)
+{
+	TArray<FString> tokens;
+	TArray<FString> switches;
+	TMap<FString, FString> params;
+	ParseCommandLine(*Params, tokens, switches, params);
+
+	const bool continueOnMismatch = switches.Contains(TEXT("ContinueOnMismatch"));
+	const bool logTransitions = switches.Contains(TEXT("LogTransitions"));
+
+	FItemSlotJournal journal;
+	const FString journalPath = params.FindRef(TEXT("Journal"));
+	if (journalPath.IsEmpty() || !journal.LoadFromFile(journalPath))
+	{
+		UE_LOG(LogItemSlots, Error, TEXT("ItemSlotReplay: could not load the journal '%s'"), *journalPath);
+		return 1;
+	}
+
+	TArray<FItemSlotJournalEntry> entries;
+	journal.GetEntries(entries);
+
+	// Accepted classes per slot, taken from the actors the slot saw.
+	TMap<uint32, TArray<TSubclassOf<ASlotableActor>>> slotClasses;
+	TSet<uint32> actorIds;
+	for (const FItemSlotJournalEntry& entry : entries)
+	{
+		TArray<TSubclassOf<ASlotableActor>>& classes = slotClasses.FindOrAdd(entry.SlotId);
+		if (entry.ActorId == 0) { continue; }
+
+		actorIds.Add(entry.ActorId);
+		classes.AddUnique(loadActorClass(journal.FindObject(entry.ActorId)));
+	}
+
+	UWorld* world = UWorld::CreateWorld(EWorldType::Game, false, TEXT("ItemSlotReplay"));
+	FWorldContext& worldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	worldContext.SetCurrentWorld(world);
+	world->InitializeActorsForPlay(FURL());
+	world->BeginPlay();
+
+	UItemSlotSubsystem* registry = UItemSlotSubsystem::Get(world);
+	if (!registry)
+	{
+		UE_LOG(LogItemSlots, Error, TEXT("ItemSlotReplay: no UItemSlotSubsystem in the replay world"));
+		GEngine->DestroyWorldContext(world);
+		world->DestroyWorld(false);
+		return 1;
+	}
+
+	TMap<uint32, UItemSlot*> slots;
+	for (const auto& pair : slotClasses)
+	{
+		AActor* owner = world->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity);
+		USceneComponent* root = NewObject<USceneComponent>(owner, TEXT("Root"));
+		owner->SetRootComponent(root);
+		root->RegisterComponent();
+
+		UItemSlot* slot = NewObject<UItemSlot>(owner, TEXT("Slot"));
+		slot->acceptedActors = pair.Value;
+		slot->SetUseSpatialRegistryOnly(true);
+		slot->SetupAttachment(root);
+		owner->AddInstanceComponent(slot);
+		slot->RegisterComponent();
+		slots.Add(pair.Key, slot);
+	}
+
+	TMap<uint32, ASlotableActor*> actors;
+	for (uint32 actorId : actorIds)
+	{
+		ASlotableActor* actor = world->SpawnActorDeferred<ASlotableActor>(loadActorClass(journal.FindObject(actorId)), FTransform::Identity);
+		if (!actor->GetRootComponent())
+		{
+			USphereComponent* collider = NewObject<USphereComponent>(actor, TEXT("Collider"));
+			actor->SetRootComponent(collider);
+			actor->AddInstanceComponent(collider);
+		}
+		actor->FinishSpawning(FTransform::Identity);
+		actors.Add(actorId, actor);
+	}
+
+	int32 mismatchNr = 0;
+	TSet<uint32> seenSlots;
+	for (int32 i = 0; i < entries.Num(); i++)
+	{
+		const FItemSlotJournalEntry& entry = entries[i];
+		UItemSlot* slot = slots.FindRef(entry.SlotId);
+		ASlotableActor* actor = actors.FindRef(entry.ActorId);
+		const FItemSlotJournalObject* slotObject = journal.FindObject(entry.SlotId);
+
+		const EControllerHand handSide = static_cast<EControllerHand>(entry.HandSide);
+
+		bool alreadySeen = false;
+		seenSlots.Add(entry.SlotId, &alreadySeen);
+
+		// A wrapped ring buffer starts mid-sequence, a slot's first entry sets its starting state.
+		// A proxy state has no actor, the actor of a rehydration only comes in with the event.
+		// The journal only holds the class the entry ended with, which is the starting one as long as the slot stayed taken.
+		if (!alreadySeen && (slot->SlotState() != entry.FromState || slot->IsProxy() != entry.bFromProxy))
+		{
+			const bool keepsClass = entry.FromState != EItemSlotState::available && entry.ToState != EItemSlotState::available;
+			registry->ReplayTransition(slot, static_cast<EItemSlotState>(entry.FromState), actor, handSide, entry.bFromProxy, keepsClass ? entry.ClassIndex : INDEX_NONE);
+		}
+
+		if (logTransitions)
+			UE_LOG(LogItemSlots, Display, TEXT("ItemSlotReplay: entry %d (frame %u, %.3fs): %s %s on %s, journaled %s -> %s"),
+				i, entry.Frame, entry.Time, slotObject ? *slotObject->Path : TEXT("?"), eventName(entry.Event), actor ? *actor->GetName() : TEXT("none"),
+				stateName(entry.FromState), stateName(entry.ToState));
+
+		// States committed directly have no input to replay.
+		if (entry.Event == FItemSlotJournalEntry::DirectCommit)
+		{
+			registry->ReplayTransition(slot, static_cast<EItemSlotState>(entry.ToState), actor, handSide, entry.bToProxy, entry.ClassIndex);
+			continue;
+		}
+
+		// Replay the input and check the state machine got to the journaled state on its own.
+		const bool accepted = registry->ReplayEvent(slot, static_cast<EItemSlotEvent>(entry.Event), actor, handSide);
+		const FItemSlotNetState& result = slot->GetNetState();
+		const bool stateMatches = accepted && result.State == entry.ToState && result.bProxy == entry.bToProxy && result.ClassIndex == entry.ClassIndex
+			&& (!keepsActor(entry.Event) || (result.Actor == actor && result.HandSide == handSide));
+		if (stateMatches) { continue; }
+
+		mismatchNr++;
+		UE_LOG(LogItemSlots, Error, TEXT("ItemSlotReplay: entry %d (frame %u, %.3fs): %s %s %s on %s, ended %s%s with %s (class %d), journal expected %s%s (class %d)"),
+			i, entry.Frame, entry.Time, slotObject ? *slotObject->Path : TEXT("?"), eventName(entry.Event), accepted ? TEXT("accepted") : TEXT("rejected"),
+			actor ? *actor->GetName() : TEXT("none"), stateName(result.State), result.bProxy ? TEXT(" (proxy)") : TEXT(""), *GetNameSafe(result.Actor), result.ClassIndex,
+			stateName(entry.ToState), entry.bToProxy ? TEXT(" (proxy)") : TEXT(""), entry.ClassIndex);
+
+		if (!continueOnMismatch) { break; }
+
+		// Put the slot back on the journaled track so the following entries are checked on their own.
+		registry->ReplayTransition(slot, static_cast<EItemSlotState>(entry.ToState), actor, handSide, entry.bToProxy, entry.ClassIndex);
+	}
+
+	UE_LOG(LogItemSlots, Display, TEXT("ItemSlotReplay: %d transition(s) on %d slot(s) and %d actor(s), %d mismatch(es)"),
+		entries.Num(), slots.Num(), actors.Num(), mismatchNr);
+
+	GEngine->DestroyWorldContext(world);
+	world->DestroyWorld(false);
+
+	return mismatchNr > 0 ? 1 : 0;
+}
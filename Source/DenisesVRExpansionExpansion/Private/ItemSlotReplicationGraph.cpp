@@ -0,0 +1,294 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ItemSlotReplicationGraph.h"
+#include "ItemSlotStats.h"
+#include "ItemSlotSettings.h"
+#include "ItemSlot.h"
+#include "SlotableActor.h"
+#include "GripMotionControllerComponent.h"
+#include "GameFramework/Pawn.h"
+#include "Engine/NetDriver.h"
+#include "Engine/NetConnection.h"
+#include "Engine/World.h"
+
+bool UReplicationGraphNode_ItemSlots::HandlesActor(const AActor* actor)
+{
+	if (!actor || actor->IsA<APawn>() || actor->bAlwaysRelevant || actor->bOnlyRelevantToOwner) { return false; }
+
+	return actor->IsA<ASlotableActor>() || actor->FindComponentByClass<UItemSlot>() != nullptr;
+}
+
+FVector UReplicationGraphNode_ItemSlots::SlotCenter(const AActor* actor)
+{
+	TInlineComponentArray<UItemSlot*> slots(actor);
+	if (slots.Num() == 0) { return actor->GetActorLocation(); }
+
+	FVector center = FVector::ZeroVector;
+	for (const UItemSlot* slot : slots)
+		center += slot->GetComponentLocation();
+	return center / slots.Num();
+}
+
+FIntVector UReplicationGraphNode_ItemSlots::toCell(const FVector& location) const
+{
+	const float cellSize = UItemSlotSettings::Get()->SlotReplicationCellSize;
+	return FIntVector(
+		FMath::FloorToInt(location.X / cellSize),
+		FMath::FloorToInt(location.Y / cellSize),
+		FMath::FloorToInt(location.Z / cellSize));
+}
+
+void UReplicationGraphNode_ItemSlots::addToCell(const FIntVector& cell, AActor* actor)
+{
+	cells.FindOrAdd(cell).Add(actor);
+}
+
+void UReplicationGraphNode_ItemSlots::removeFromCell(const FIntVector& cell, AActor* actor)
+{
+	FActorRepListRefView* list = cells.Find(cell);
+	if (!list) { return; }
+
+	list->RemoveFast(actor);
+	if (list->Num() == 0)
+		cells.Remove(cell);
+}
+
+void UReplicationGraphNode_ItemSlots::NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo)
+{
+	AActor* actor = ActorInfo.Actor;
+	if (!actor || ownerIndices.Contains(actor)) { return; }
+
+	ownerIndices.Add(actor, owners.Num());
+	FSlotOwner& owner = owners.AddDefaulted_GetRef();
+	owner.Actor = actor;
+	owner.Center = SlotCenter(actor);
+	owner.Cell = toCell(owner.Center);
+	owner.bMovable = actor->GetRootComponent() && actor->GetRootComponent()->Mobility == EComponentMobility::Movable;
+	addToCell(owner.Cell, actor);
+}
+
+bool UReplicationGraphNode_ItemSlots::NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound)
+{
+	int32 index = INDEX_NONE;
+	if (!ownerIndices.RemoveAndCopyValue(ActorInfo.Actor, index))
+	{
+		UE_CLOG(bWarnIfNotFound, LogItemSlots, Warning, TEXT("UReplicationGraphNode_ItemSlots: %s was not added"), *GetNameSafe(ActorInfo.Actor));
+		return false;
+	}
+
+	removeFromCell(owners[index].Cell, owners[index].Actor);
+	owners.RemoveAtSwap(index);
+	if (owners.IsValidIndex(index))
+		ownerIndices[owners[index].Actor] = index;
+	return true;
+}
+
+void UReplicationGraphNode_ItemSlots::NotifyResetAllNetworkActors()
+{
+	owners.Reset();
+	ownerIndices.Reset();
+	cells.Reset();
+	connectionStats.Reset();
+}
+
+void UReplicationGraphNode_ItemSlots::PrepareForReplication()
+{
+	ITEMSLOTS_SCOPE(RepGraphPrepare);
+
+	// Most slot owners are static furniture, only movable ones (and the slotable actors) can change cell.
+	for (FSlotOwner& owner : owners)
+	{
+		if (!owner.bMovable) { continue; }
+
+		owner.Center = SlotCenter(owner.Actor);
+		const FIntVector cell = toCell(owner.Center);
+		if (cell == owner.Cell) { continue; }
+
+		removeFromCell(owner.Cell, owner.Actor);
+		owner.Cell = cell;
+		addToCell(owner.Cell, owner.Actor);
+	}
+
+	for (auto it = connectionStats.CreateIterator(); it; ++it)
+	{
+		if (!it->Key.IsValid())
+			it.RemoveCurrent();
+	}
+}
+
+void UReplicationGraphNode_ItemSlots::forEachRelevantCell(TArrayView<const FVector> viewLocations, TFunctionRef<void(const FActorRepListRefView&)> visit) const
+{
+	const UItemSlotSettings* settings = UItemSlotSettings::Get();
+	const float cellSize = settings->SlotReplicationCellSize;
+	const float relevancyRadius = settings->SlotRelevancyRadius;
+	const float relevancyRadiusSquared = FMath::Square(relevancyRadius);
+
+	// Viewers of one connection (split screen) are usually close together, a cell in reach of several is visited once.
+	TArray<FIntVector, TInlineAllocator<64>> visited;
+	for (const FVector& view : viewLocations)
+	{
+		const FIntVector minCell = toCell(view - FVector(relevancyRadius));
+		const FIntVector maxCell = toCell(view + FVector(relevancyRadius));
+
+		for (int32 x = minCell.X; x <= maxCell.X; x++)
+		for (int32 y = minCell.Y; y <= maxCell.Y; y++)
+		for (int32 z = minCell.Z; z <= maxCell.Z; z++)
+		{
+			const FIntVector cell(x, y, z);
+			const FActorRepListRefView* list = cells.Find(cell);
+			if (!list) { continue; }
+
+			// The cell range is a cube around the view, its corners are further away than the radius.
+			const FBox cellBounds(FVector(cell) * cellSize, FVector(cell + FIntVector(1)) * cellSize);
+			if (cellBounds.ComputeSquaredDistanceToPoint(view) > relevancyRadiusSquared) { continue; }
+
+			if (viewLocations.Num() > 1)
+			{
+				if (visited.Contains(cell)) { continue; }
+				visited.Add(cell);
+			}
+			visit(*list);
+		}
+	}
+}
+
+bool UReplicationGraphNode_ItemSlots::isNearHand(const AActor* actor, TArrayView<const FVector> handLocations) const
+{
+	const float handRadiusSquared = FMath::Square(UItemSlotSettings::Get()->SlotHandRadius);
+	const FVector center = owners[ownerIndices.FindChecked(actor)].Center;
+
+	for (const FVector& hand : handLocations)
+	{
+		if (FVector::DistSquared(hand, center) <= handRadiusSquared)
+			return true;
+	}
+	return false;
+}
+
+void UReplicationGraphNode_ItemSlots::gatherConnection(TArrayView<const FVector> viewLocations, TArrayView<const FVector> handLocations, FConnectionStats& outStats,
+	TFunctionRef<void(const FActorRepListRefView&)> onCell, TFunctionRef<void(AActor*, int32)> onOwner) const
+{
+	const int32 throttledPeriod = UItemSlotSettings::Get()->ThrottledSlotReplicationPeriod;
+
+	outStats = FConnectionStats();
+	forEachRelevantCell(viewLocations, [&](const FActorRepListRefView& list)
+		{
+			onCell(list);
+			outStats.GatheredCells++;
+
+			for (AActor* actor : list)
+			{
+				const bool nearHand = isNearHand(actor, handLocations);
+				onOwner(actor, nearHand ? 1 : throttledPeriod);
+
+				outStats.GatheredOwners++;
+				if (!nearHand)
+					outStats.ThrottledOwners++;
+			}
+		});
+}
+
+void UReplicationGraphNode_ItemSlots::GatherOwners(TArrayView<const FVector> viewLocations, TArrayView<const FVector> handLocations,
+	TArray<FGatheredOwner>& outOwners, FConnectionStats& outStats) const
+{
+	gatherConnection(viewLocations, handLocations, outStats,
+		[](const FActorRepListRefView&) {},
+		[&outOwners](AActor* actor, int32 period) { outOwners.Add({ actor, period }); });
+}
+
+void UReplicationGraphNode_ItemSlots::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	ITEMSLOTS_SCOPE(RepGraphGather);
+
+	// Motion controllers of the viewers' pawns. Viewers without any count with their view location instead.
+	TArray<FVector, TInlineAllocator<4>> viewLocations;
+	TArray<FVector, TInlineAllocator<8>> handLocations;
+	for (const FNetViewer& viewer : Params.Viewers)
+	{
+		viewLocations.Add(viewer.ViewLocation);
+
+		const int32 handNr = handLocations.Num();
+		if (const APawn* pawn = Cast<APawn>(viewer.ViewTarget))
+		{
+			TInlineComponentArray<UGripMotionControllerComponent*> controllers(pawn);
+			for (const UGripMotionControllerComponent* controller : controllers)
+				handLocations.Add(controller->GetComponentLocation());
+		}
+
+		if (handLocations.Num() == handNr)
+			handLocations.Add(viewer.ViewLocation);
+	}
+
+	FConnectionStats& stats = connectionStats.FindOrAdd(&Params.ConnectionManager);
+	gatherConnection(viewLocations, handLocations, stats,
+		[&Params](const FActorRepListRefView& list) { Params.OutGatheredReplicationLists.AddReplicationActorList(list); },
+		[&Params](AActor* actor, int32 period)
+		{
+			// Only the period of this connection changes, other connections near the owner keep their own.
+			Params.ConnectionManager.ActorInfoMap.FindOrAdd(actor).ReplicationPeriodFrame = period;
+		});
+
+	INC_DWORD_STAT_BY(STAT_ItemSlots_RepGraphGathered, stats.GatheredOwners);
+	INC_DWORD_STAT_BY(STAT_ItemSlots_RepGraphThrottled, stats.ThrottledOwners);
+}
+
+void UItemSlotReplicationGraph::InitGlobalGraphNodes()
+{
+	Super::InitGlobalGraphNodes();
+
+	itemSlotNode = CreateNewNode<UReplicationGraphNode_ItemSlots>();
+	AddGlobalGraphNode(itemSlotNode);
+}
+
+void UItemSlotReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
+{
+	if (UReplicationGraphNode_ItemSlots::HandlesActor(ActorInfo.Actor))
+		itemSlotNode->NotifyAddNetworkActor(ActorInfo);
+	else
+		Super::RouteAddNetworkActorToNodes(ActorInfo, GlobalInfo);
+}
+
+void UItemSlotReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
+{
+	// Routed by where the actor went when it was added, its components may have changed since.
+	if (!itemSlotNode->NotifyRemoveNetworkActor(ActorInfo, false))
+		Super::RouteRemoveNetworkActorToNodes(ActorInfo);
+}
+
+void UItemSlotReplicationGraph::SetActorPooled(AActor* actor, bool pooled)
+{
+	if (!actor || !itemSlotNode) { return; }
+
+	const FNewReplicatedActorInfo actorInfo(actor);
+	if (pooled)
+		itemSlotNode->NotifyRemoveNetworkActor(actorInfo, false);
+	else if (!itemSlotNode->ContainsActor(actor))
+		itemSlotNode->NotifyAddNetworkActor(actorInfo);
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GItemSlotRepGraphStatsCommand(
+	TEXT("DVREE.Slots.RepGraphStats"),
+	TEXT("Logs, per client connection, how many slot owners UItemSlotReplicationGraph gathered last frame and how many of them were throttled."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& args, UWorld* world)
+		{
+			UNetDriver* netDriver = world ? world->GetNetDriver() : nullptr;
+			const UItemSlotReplicationGraph* graph = netDriver ? Cast<UItemSlotReplicationGraph>(netDriver->GetReplicationDriver()) : nullptr;
+			if (!graph || !graph->GetItemSlotNode())
+			{
+				UE_LOG(LogItemSlots, Log, TEXT("No UItemSlotReplicationGraph on this world's net driver"));
+				return;
+			}
+
+			const UReplicationGraphNode_ItemSlots* node = graph->GetItemSlotNode();
+			UE_LOG(LogItemSlots, Log, TEXT("%d slot owner(s) in the replication graph"), node->NumSlotOwners());
+
+			for (const auto& entry : node->GetConnectionStats())
+			{
+				const UNetReplicationGraphConnection* connectionManager = entry.Key.Get();
+				if (const UNetConnection* connection = connectionManager ? connectionManager->NetConnection : nullptr)
+				{
+					UE_LOG(LogItemSlots, Log, TEXT("%s: %d cell(s), %d slot owner(s), %d throttled"),
+						*connection->LowLevelGetRemoteAddress(true), entry.Value.GatheredCells, entry.Value.GatheredOwners, entry.Value.ThrottledOwners);
+				}
+			}
+		}));
@@ -0,0 +1,189 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ItemSlotReplicationMeasure.h"
+#include "ItemSlotStats.h"
+#include "ItemSlot.h"
+#include "ItemSlotState.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "UObject/CoreNet.h"
+#include "UObject/UnrealType.h"
+
+namespace
+{
+	//	Every property UItemSlot flagged Replicated before the authoring data split.
+	const TCHAR* const LegacySlotProperties[] = {
+		TEXT("boxMesh"), TEXT("sphereMesh"), TEXT("triggerVisuals"), TEXT("rootVisuals"), TEXT("currentlyDisplayedVisuals"),
+		TEXT("currentlyDisplayedSlotableActor"), TEXT("transformRoot"), TEXT("leftHandMaterial"), TEXT("rightHandMaterial"), TEXT("editorColliderMaterial"),
+	};
+
+	//	Removed properties, with the FItemSlotNetState member of the same type that took their place.
+	const TCHAR* const LegacyNetStateProperties[][2] = {
+		{ TEXT("currentState"), TEXT("State") },
+		{ TEXT("reservedForActor"), TEXT("Actor") },
+	};
+}
+
+int64 FItemSlotReplicationMeasure::MeasureObjectBits(const UObject* object)
+{
+	if (!object) { return 0; }
+	return MeasureClassBits(object, object->GetClass());
+}
+
+int64 FItemSlotReplicationMeasure::MeasureClassBits(const UObject* object, const UClass* fromClass)
+{
+	if (!object || !fromClass) { return 0; }
+
+	int64 bits = 0;
+	for (TFieldIterator<FProperty> it(fromClass); it; ++it)
+	{
+		if (!it->HasAnyPropertyFlags(CPF_Net)) { continue; }
+
+		for (int32 i = 0; i < it->ArrayDim; i++)
+			bits += MeasurePropertyBits(*it, it->ContainerPtrToValuePtr<void>(object, i));
+	}
+	return bits;
+}
+
+int64 FItemSlotReplicationMeasure::MeasureSlotStateBits(const UItemSlot* slot)
+{
+	static const FProperty* property = FindFProperty<FProperty>(UItemSlot::StaticClass(), TEXT("netState"));
+	if (!slot || !property) { return 0; }
+
+	return MeasurePropertyBits(property, property->ContainerPtrToValuePtr<void>(slot));
+}
+
+int64 FItemSlotReplicationMeasure::MeasureSlotOwnerBits(const AActor* actor, int32* outSlotNr)
+{
+	if (!actor) { return 0; }
+
+	TInlineComponentArray<UItemSlot*> slots(actor);
+
+	int64 bits = 0;
+	for (const UItemSlot* slot : slots)
+		bits += MeasureObjectBits(slot);
+
+	if (outSlotNr)
+		*outSlotNr = slots.Num();
+	return bits;
+}
+
+int64 FItemSlotReplicationMeasure::MeasurePropertyBits(const FProperty* property, const void* data)
+{
+	if (property->IsA<FObjectPropertyBase>() || property->IsA<FInterfaceProperty>())
+		return NetGUIDBits;
+
+	if (const FStructProperty* structProperty = CastField<FStructProperty>(property))
+	{
+		if (structProperty->Struct == FItemSlotNetState::StaticStruct())
+			return MeasureNetStateBits(*static_cast<const FItemSlotNetState*>(data));
+
+		// Structs without a native NetSerialize are replicated property by property.
+		if (!(structProperty->Struct->StructFlags & STRUCT_NetSerializeNative))
+		{
+			int64 bits = 0;
+			for (TFieldIterator<FProperty> it(structProperty->Struct); it; ++it)
+			{
+				if (it->HasAnyPropertyFlags(CPF_RepSkip)) { continue; }
+
+				for (int32 i = 0; i < it->ArrayDim; i++)
+					bits += MeasurePropertyBits(*it, it->ContainerPtrToValuePtr<void>(data, i));
+			}
+			return bits;
+		}
+	}
+
+	if (const FArrayProperty* arrayProperty = CastField<FArrayProperty>(property))
+	{
+		FScriptArrayHelper helper(arrayProperty, data);
+
+		// Element count, as written by the rep layout.
+		int64 bits = 16;
+		for (int32 i = 0; i < helper.Num(); i++)
+			bits += MeasurePropertyBits(arrayProperty->Inner, helper.GetRawPtr(i));
+		return bits;
+	}
+
+	// No package map here, an object reference would be written as garbage or crash.
+	TArray<const FStructProperty*> encounteredStructs;
+	const EPropertyObjectReferenceType anyReference = EPropertyObjectReferenceType::Strong | EPropertyObjectReferenceType::Weak | EPropertyObjectReferenceType::Soft;
+	if (!ensureMsgf(!property->ContainsObjectReference(encounteredStructs, anyReference), TEXT("%s holds object references and can't be measured without a package map"), *property->GetName()))
+		return 0;
+
+	FNetBitWriter writer(nullptr, 256);
+	property->NetSerializeItem(writer, nullptr, const_cast<void*>(data));
+	return writer.GetNumBits();
+}
+
+int64 FItemSlotReplicationMeasure::MeasureLegacySlotBits(const UItemSlot* slot)
+{
+	if (!slot) { return 0; }
+
+	// Inherited properties replicate the same before and after, they are walked like MeasureObjectBits does.
+	int64 bits = MeasureClassBits(slot, UItemSlot::StaticClass()->GetSuperClass());
+
+	for (const TCHAR* name : LegacySlotProperties)
+	{
+		const FProperty* property = FindFProperty<FProperty>(UItemSlot::StaticClass(), name);
+		if (ensureMsgf(property, TEXT("UItemSlot::%s is gone, update LegacySlotProperties"), name))
+			bits += MeasurePropertyBits(property, property->ContainerPtrToValuePtr<void>(slot));
+	}
+
+	for (const auto& names : LegacyNetStateProperties)
+	{
+		const FProperty* property = FindFProperty<FProperty>(FItemSlotNetState::StaticStruct(), names[1]);
+		if (ensureMsgf(property, TEXT("FItemSlotNetState::%s standing in for %s is gone"), names[1], names[0]))
+			bits += MeasurePropertyBits(property, property->ContainerPtrToValuePtr<void>(&slot->GetNetState()));
+	}
+	return bits;
+}
+
+int64 FItemSlotReplicationMeasure::MeasureNetStateBits(const FItemSlotNetState& state)
+{
+	// No package map here, the actor is left out of the serialized copy and counted as a NetGUID.
+	FItemSlotNetState withoutActor = state;
+	withoutActor.Actor = nullptr;
+
+	FNetBitWriter writer(nullptr, 64);
+	bool success = true;
+	withoutActor.NetSerialize(writer, nullptr, success);
+	return writer.GetNumBits() + (state.Actor ? NetGUIDBits : 0);
+}
+
+int64 FItemSlotReplicationMeasure::MeasureReflectedNetStateBits(const FItemSlotNetState& state)
+{
+	// State, hand and class index bytes, the proxy bit. A null reference still writes a packed zero NetGUID.
+	return 8 + 8 + 8 + 1 + (state.Actor ? NetGUIDBits : 8);
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GItemSlotMeasureReplicationCommand(
+	TEXT("DVREE.Slots.MeasureReplication"),
+	TEXT("Logs the estimated initial replication size of the item slots of every slot owning actor in the world."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& args, UWorld* world)
+		{
+			if (!world) { return; }
+
+			int64 totalBits = 0;
+			int64 totalLegacyBits = 0;
+			int32 ownerNr = 0;
+			for (TActorIterator<AActor> it(world); it; ++it)
+			{
+				int32 slotNr = 0;
+				const int64 bits = FItemSlotReplicationMeasure::MeasureSlotOwnerBits(*it, &slotNr);
+				if (slotNr == 0) { continue; }
+
+				int64 legacyBits = 0;
+				TInlineComponentArray<UItemSlot*> slots(*it);
+				for (const UItemSlot* slot : slots)
+					legacyBits += FItemSlotReplicationMeasure::MeasureLegacySlotBits(slot);
+
+				UE_LOG(LogItemSlots, Log, TEXT("%s: %d slot(s), %lld bytes (%lld before the data split)"), *it->GetName(), slotNr, (bits + 7) / 8, (legacyBits + 7) / 8);
+				totalBits += bits;
+				totalLegacyBits += legacyBits;
+				ownerNr++;
+			}
+
+			if (ownerNr > 0)
+				UE_LOG(LogItemSlots, Log, TEXT("%d slot owner(s), %lld bytes on average per initial replication (%lld before the data split)"),
+					ownerNr, (totalBits / ownerNr + 7) / 8, (totalLegacyBits / ownerNr + 7) / 8);
+		}));
@@ -0,0 +1,8 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ItemSlotSettings.h"
+
+UItemSlotSettings::UItemSlotSettings()
+{
+	SectionName = TEXT("Item Slots");
+}
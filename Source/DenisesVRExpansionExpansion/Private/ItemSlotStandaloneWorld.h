@@ -0,0 +1,38 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+/**
+ * Standalone game world without a net driver, for the slot benchmark and the automation tests. Server RPCs and multicasts run
+ * locally like on a listen server. Destroyed with its context when it goes out of scope.
+ */
+struct FItemSlotStandaloneWorld
+{
+	explicit FItemSlotStandaloneWorld(const TCHAR* name, bool beginPlay = true)
+	{
+		World = UWorld::CreateWorld(EWorldType::Game, false, name);
+		FWorldContext& worldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+		worldContext.SetCurrentWorld(World);
+		World->InitializeActorsForPlay(FURL());
+		if (beginPlay)
+			World->BeginPlay();
+	}
+
+	~FItemSlotStandaloneWorld()
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+	}
+
+	//	A full world tick: actors, components, overlaps and tickable subsystems such as UItemSlotSubsystem.
+	void Tick(float deltaTime)
+	{
+		World->Tick(LEVELTICK_All, deltaTime);
+	}
+
+	UWorld* World = nullptr;
+};
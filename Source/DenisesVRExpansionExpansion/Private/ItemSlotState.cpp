@@ -0,0 +1,51 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ItemSlotState.h"
+#include "GameFramework/Actor.h"
+#include "UObject/CoreNet.h"
+
+namespace
+{
+	const uint32 StateBits = 2;
+}
+
+bool FItemSlotNetState::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	uint8 state = State.GetValue();
+	Ar.SerializeBits(&state, StateBits);
+
+	uint32 hand = static_cast<uint32>(HandSide);
+	Ar.SerializeInt(hand, static_cast<uint32>(EControllerHand::ControllerHand_Count));
+
+	// Most slots display nothing, a single bit then. Class indices are small, packed they take a byte.
+	uint8 hasClass = ClassIndex != INDEX_NONE;
+	Ar.SerializeBits(&hasClass, 1);
+	uint32 classIndex = hasClass ? static_cast<uint32>(ClassIndex) : 0;
+	if (hasClass)
+		Ar.SerializeIntPacked(classIndex);
+
+	uint8 proxy = bProxy;
+	Ar.SerializeBits(&proxy, 1);
+
+	// Only written when set, so the state can be measured without a package map as long as it has no actor.
+	uint8 hasActor = Actor != nullptr;
+	Ar.SerializeBits(&hasActor, 1);
+
+	UObject* actor = Actor;
+	if (hasActor)
+		bOutSuccess = Map->SerializeObject(Ar, AActor::StaticClass(), actor);
+	else
+		bOutSuccess = true;
+
+	if (Ar.IsLoading())
+	{
+		State = static_cast<EItemSlotState>(state);
+		HandSide = static_cast<EControllerHand>(hand);
+		ClassIndex = hasClass ? static_cast<int8>(classIndex) : INDEX_NONE;
+		bProxy = proxy != 0;
+		Actor = hasActor ? Cast<AActor>(actor) : nullptr;
+	}
+
+	bOutSuccess &= !Ar.IsError();
+	return true;
+}
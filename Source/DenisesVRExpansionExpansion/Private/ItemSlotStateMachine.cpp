@@ -0,0 +1,123 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ItemSlotStateMachine.h"
+#include "ItemSlot.h"
+#include "SlotableActor.h"
+
+const TCHAR* ItemSlotStateMachine::EventName(EItemSlotEvent event)
+{
+	switch (event)
+	{
+	case EItemSlotEvent::Reserve:			return TEXT("Reserve");
+	case EItemSlotEvent::CancelReservation:	return TEXT("CancelReservation");
+	case EItemSlotEvent::Receive:			return TEXT("Receive");
+	case EItemSlotEvent::Remove:			return TEXT("Remove");
+	case EItemSlotEvent::Insert:			return TEXT("Insert");
+	case EItemSlotEvent::InsertProxy:		return TEXT("InsertProxy");
+	case EItemSlotEvent::Dehydrate:			return TEXT("Dehydrate");
+	case EItemSlotEvent::Rehydrate:			return TEXT("Rehydrate");
+	default:								return TEXT("Unknown");
+	}
+}
+
+bool TItemSlotTransition<EItemSlotEvent::Reserve>::Guard(const UItemSlot& slot, const FItemSlotNetState& current, const ASlotableActor* actor)
+{
+	return actor && slot.acceptedIndexFor(actor->GetClass()) != INDEX_NONE;
+}
+
+FItemSlotNetState TItemSlotTransition<EItemSlotEvent::Reserve>::MakeState(const UItemSlot& slot, const FItemSlotNetState& current, ASlotableActor* actor, EControllerHand handSide)
+{
+	FItemSlotNetState newState;
+	newState.State = EItemSlotState::reserved;
+	newState.HandSide = handSide;
+	newState.Actor = actor;
+	newState.ClassIndex = slot.acceptedIndexFor(actor->GetClass());
+	return newState;
+}
+
+bool TItemSlotTransition<EItemSlotEvent::CancelReservation>::Guard(const UItemSlot& slot, const FItemSlotNetState& current, const ASlotableActor* actor)
+{
+	return actor && current.Actor == actor;
+}
+
+bool TItemSlotTransition<EItemSlotEvent::Receive>::Guard(const UItemSlot& slot, const FItemSlotNetState& current, const ASlotableActor* actor)
+{
+	return actor && current.Actor == actor;
+}
+
+FItemSlotNetState TItemSlotTransition<EItemSlotEvent::Receive>::MakeState(const UItemSlot& slot, const FItemSlotNetState& current, ASlotableActor* actor, EControllerHand handSide)
+{
+	FItemSlotNetState newState = current;
+	newState.State = EItemSlotState::occupied;
+	return newState;
+}
+
+void TItemSlotTransition<EItemSlotEvent::Receive>::OnCommitted(UItemSlot& slot)
+{
+	slot.OnActorReceivedEvent.Broadcast();
+}
+
+void TItemSlotTransition<EItemSlotEvent::Remove>::OnCommitted(UItemSlot& slot)
+{
+	slot.OnActorExitEvent.Broadcast();
+}
+
+bool TItemSlotTransition<EItemSlotEvent::Insert>::Guard(const UItemSlot& slot, const FItemSlotNetState& current, const ASlotableActor* actor)
+{
+	return actor && slot.acceptedIndexFor(actor->GetClass()) != INDEX_NONE;
+}
+
+FItemSlotNetState TItemSlotTransition<EItemSlotEvent::Insert>::MakeState(const UItemSlot& slot, const FItemSlotNetState& current, ASlotableActor* actor, EControllerHand handSide)
+{
+	FItemSlotNetState newState;
+	newState.State = EItemSlotState::occupied;
+	newState.Actor = actor;
+	newState.ClassIndex = slot.acceptedIndexFor(actor->GetClass());
+	return newState;
+}
+
+void TItemSlotTransition<EItemSlotEvent::Insert>::OnCommitted(UItemSlot& slot)
+{
+	slot.OnActorReceivedEvent.Broadcast();
+}
+
+bool TItemSlotTransition<EItemSlotEvent::InsertProxy>::Guard(const UItemSlot& slot, const FItemSlotNetState& current, const ASlotableActor* actor)
+{
+	return actor == nullptr && slot.proxyRecord.ActorClass && slot.acceptedIndexFor(slot.proxyRecord.ActorClass) != INDEX_NONE;
+}
+
+FItemSlotNetState TItemSlotTransition<EItemSlotEvent::InsertProxy>::MakeState(const UItemSlot& slot, const FItemSlotNetState& current, ASlotableActor* actor, EControllerHand handSide)
+{
+	FItemSlotNetState newState;
+	newState.State = EItemSlotState::occupied;
+	newState.ClassIndex = slot.acceptedIndexFor(slot.proxyRecord.ActorClass);
+	newState.bProxy = true;
+	return newState;
+}
+
+void TItemSlotTransition<EItemSlotEvent::InsertProxy>::OnCommitted(UItemSlot& slot)
+{
+	slot.OnActorReceivedEvent.Broadcast();
+}
+
+bool TItemSlotTransition<EItemSlotEvent::Dehydrate>::Guard(const UItemSlot& slot, const FItemSlotNetState& current, const ASlotableActor* actor)
+{
+	return actor && current.Actor == actor;
+}
+
+FItemSlotNetState TItemSlotTransition<EItemSlotEvent::Dehydrate>::MakeState(const UItemSlot& slot, const FItemSlotNetState& current, ASlotableActor* actor, EControllerHand handSide)
+{
+	FItemSlotNetState newState = current;
+	newState.Actor = nullptr;
+	newState.ClassIndex = slot.acceptedIndexFor(actor->GetClass());
+	newState.bProxy = true;
+	return newState;
+}
+
+FItemSlotNetState TItemSlotTransition<EItemSlotEvent::Rehydrate>::MakeState(const UItemSlot& slot, const FItemSlotNetState& current, ASlotableActor* actor, EControllerHand handSide)
+{
+	FItemSlotNetState newState = current;
+	newState.Actor = actor;
+	newState.bProxy = false;
+	return newState;
+}
@@ -0,0 +1,1414 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ItemSlotSubsystem.h"
+#include "ItemSlot.h"
+#include "SlotableActor.h"
+#include "ItemSlotSettings.h"
+#include "ItemSlotStats.h"
+#include "ItemSlotNetObjectFilter.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "GripMotionControllerComponent.h"
+#include "GameFramework/WorldSettings.h"
+#include "Engine/GameInstance.h"
+#include "Components/StaticMeshComponent.h"
+#include "Components/SphereComponent.h"
+#include "Components/BoxComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Serialization/MemoryReader.h"
+#include "EngineUtils.h"
+
+DEFINE_STAT(STAT_ItemSlots_ReservationSwitches);
+DEFINE_STAT(STAT_ItemSlots_SuppressedSwitches);
+DEFINE_STAT(STAT_ItemSlots_ComparedSlots);
+DEFINE_STAT(STAT_ItemSlots_DirtySlots);
+DEFINE_STAT(STAT_ItemSlots_Rpcs);
+DEFINE_STAT(STAT_ItemSlots_SlotEvents);
+DEFINE_STAT(STAT_ItemSlots_RejectedTransitions);
+DEFINE_STAT(STAT_ItemSlots_Predictions);
+DEFINE_STAT(STAT_ItemSlots_Mispredictions);
+DEFINE_STAT(STAT_ItemSlots_ActiveGrippers);
+DEFINE_STAT(STAT_ItemSlots_CandidateSlots);
+DEFINE_STAT(STAT_ItemSlots_LazyTriggers);
+DEFINE_STAT(STAT_ItemSlots_ProxySlots);
+DEFINE_STAT(STAT_ItemSlots_PooledProxyActors);
+DEFINE_STAT(STAT_ItemSlots_Rehydrations);
+DEFINE_STAT(STAT_ItemSlots_PendingSetups);
+DEFINE_STAT(STAT_ItemSlots_ResidentPreviewMeshes);
+DEFINE_STAT(STAT_ItemSlots_PreviewMeshRequests);
+DEFINE_STAT(STAT_ItemSlots_SetupTotalMs);
+DEFINE_STAT(STAT_ItemSlots_SetupWorstFrameMs);
+DEFINE_STAT(STAT_ItemSlots_ReservationsPerSecond);
+DEFINE_STAT(STAT_ItemSlots_RpcsPerSecond);
+DEFINE_STAT(STAT_ItemSlots_MispredictRate);
+DEFINE_STAT(STAT_ItemSlots_RepGraphGathered);
+DEFINE_STAT(STAT_ItemSlots_RepGraphThrottled);
+
+DEFINE_STAT(STAT_ItemSlots_Tick);
+DEFINE_STAT(STAT_ItemSlots_Solve);
+DEFINE_STAT(STAT_ItemSlots_FindCompatible);
+DEFINE_STAT(STAT_ItemSlots_RegistryRefresh);
+DEFINE_STAT(STAT_ItemSlots_ManualFind);
+DEFINE_STAT(STAT_ItemSlots_FindNearest);
+DEFINE_STAT(STAT_ItemSlots_ApplyNearest);
+DEFINE_STAT(STAT_ItemSlots_Overlap);
+DEFINE_STAT(STAT_ItemSlots_ApplyNetState);
+DEFINE_STAT(STAT_ItemSlots_SetupTrigger);
+DEFINE_STAT(STAT_ItemSlots_ApplyLoadout);
+DEFINE_STAT(STAT_ItemSlots_DeferredSetup);
+DEFINE_STAT(STAT_ItemSlots_LazyTriggerUpdate);
+DEFINE_STAT(STAT_ItemSlots_ProxyUpdate);
+DEFINE_STAT(STAT_ItemSlots_DispatchEvents);
+DEFINE_STAT(STAT_ItemSlots_RepGraphGather);
+DEFINE_STAT(STAT_ItemSlots_RepGraphPrepare);
+
+CSV_DEFINE_CATEGORY(ItemSlots, true);
+DEFINE_LOG_CATEGORY(LogItemSlots);
+
+void UItemSlotSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	cellSize = UItemSlotSettings::Get()->RegistryCellSize;
+	journal.SetCapacity(UItemSlotSettings::Get()->JournalCapacity);
+}
+
+void UItemSlotSubsystem::Deinitialize()
+{
+	registeredSlots.Empty();
+	freeIndices.Empty();
+	movedSlots.Empty();
+	grid.Empty();
+	slotableClasses.Empty();
+	slotableClassIds.Empty();
+	grippers.Empty();
+	ownerActiveSlots.Empty();
+	ownerSlots.Empty();
+	awakeOwnerSlotNr = 0;
+	journal.SetCapacity(0);
+	pendingSlotEvents.Empty();
+	dispatchingSlotEvents.Empty();
+	previewPool.Empty();
+	previewBatches.Empty();
+	previewBatchIds.Empty();
+	previewBatchComponents.Empty();
+	ghostPreviews.Empty();
+	previewMeshWaiters.Empty();
+	for (FResidentPreviewMesh& resident : residentPreviewMeshes)
+	{
+		if (resident.Handle.IsValid())
+			resident.Handle->CancelHandle();
+	}
+	residentPreviewMeshes.Empty();
+	residentPreviewMeshIndices.Empty();
+	freeResidentPreviewMeshes.Empty();
+	oldestResidentPreviewMesh = INDEX_NONE;
+	newestResidentPreviewMesh = INDEX_NONE;
+	hydratedSlots.Empty();
+	proxyActorPool.Empty();
+	unregisteredProxyRecords.Empty();
+	proxySlotNr = 0;
+
+	Super::Deinitialize();
+}
+
+void UItemSlotSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (InWorld.GetNetMode() == NM_DedicatedServer) { return; }
+
+	// One preview per local hand is the most that can be visible at once in the common case.
+	const UGameInstance* gameInstance = InWorld.GetGameInstance();
+	const int32 localHandNr = FMath::Max(1, gameInstance ? gameInstance->GetNumLocalPlayers() : 1) * 2;
+	for (int32 i = 0; i < localHandNr; i++)
+	{
+		if (UStaticMeshComponent* component = createPreviewComponent())
+			previewPool.Add(component);
+	}
+}
+
+void UItemSlotSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	ITEMSLOTS_SCOPE(Tick);
+	const double tickStart = FPlatformTime::Seconds();
+	if (GetWorld()->GetNetMode() == NM_Client)
+	{
+		predictReservations();
+	}
+	else
+	{
+		runPendingSetups();
+		assignNetObjectFilters();
+		updateLazyTriggers();
+		updateProxies();
+		solveNearestSlots();
+		dispatchSlotEvents();
+		updateReplicationStats();
+	}
+	refreshGhostPreviews();
+	updateRateStats(DeltaTime);
+	lastTickMs = (FPlatformTime::Seconds() - tickStart) * 1000.0;
+}
+
+TStatId UItemSlotSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UItemSlotSubsystem, STATGROUP_Tickables);
+}
+
+bool UItemSlotSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+UItemSlotSubsystem* UItemSlotSubsystem::Get(const UObject* worldContext)
+{
+	if (!worldContext) { return nullptr; }
+
+	UWorld* world = worldContext->GetWorld();
+	return world ? world->GetSubsystem<UItemSlotSubsystem>() : nullptr;
+}
+
+void UItemSlotSubsystem::CountReservationSwitch(bool suppressed)
+{
+	if (suppressed)
+	{
+		suppressedSwitchCount++;
+		INC_DWORD_STAT(STAT_ItemSlots_SuppressedSwitches);
+	}
+	else
+	{
+		reservationSwitchCount++;
+		INC_DWORD_STAT(STAT_ItemSlots_ReservationSwitches);
+	}
+}
+
+void UItemSlotSubsystem::CountRpc()
+{
+	rpcCount++;
+	INC_DWORD_STAT(STAT_ItemSlots_Rpcs);
+}
+
+void UItemSlotSubsystem::CountPredictionResult(bool confirmed)
+{
+	predictionCount++;
+	INC_DWORD_STAT(STAT_ItemSlots_Predictions);
+
+	if (confirmed) { return; }
+
+	mispredictionCount++;
+	INC_DWORD_STAT(STAT_ItemSlots_Mispredictions);
+}
+
+void UItemSlotSubsystem::RegisterSlot(UItemSlot* slot)
+{
+	if (!slot || slot->registryIndex != INDEX_NONE) { return; }
+
+	int32 index;
+	if (freeIndices.Num() > 0)
+		index = freeIndices.Pop();
+	else
+		index = registeredSlots.AddDefaulted();
+
+	FRegisteredSlot& entry = registeredSlots[index];
+	entry = FRegisteredSlot();
+	entry.Slot = slot;
+	slot->registryIndex = index;
+
+	slot->rebuildCompatibilityBits(this);
+	addToCells(index);
+
+	AActor* owner = slot->GetOwner();
+	if (owner)
+	{
+		FOwnerSlots& counts = ownerSlots.FindOrAdd(owner);
+		if (counts.SlotNr++ == 0)
+			counts.bAwake = owner->NetDormancy <= DORM_Awake;
+		if (counts.bAwake)
+			awakeOwnerSlotNr++;
+	}
+
+	if (owner && owner->HasAuthority() && canManageDormancy(owner) && !ownerActiveSlots.Contains(owner))
+		setOwnerDormancy(owner, DORM_DormantAll);
+
+	if (owner && owner->HasAuthority())
+	{
+		QueueNetObjectFilter(owner);
+		restoreProxyRecord(slot);
+	}
+}
+
+void UItemSlotSubsystem::UnregisterSlot(UItemSlot* slot)
+{
+	if (!slot || !registeredSlots.IsValidIndex(slot->registryIndex)) { return; }
+
+	const int32 index = slot->registryIndex;
+	removeFromCells(index);
+
+	// The index may be handed to another slot before the events are dispatched.
+	pendingSlotEvents.RemoveAll([index](const FSlotEvent& event) { return event.Index == index; });
+	for (FSlotEvent& event : dispatchingSlotEvents)
+	{
+		if (event.Index == index)
+			event.Index = INDEX_NONE;
+	}
+
+	pendingSetups.Remove(slot);
+
+	if (slot->bLazyTrigger)
+	{
+		slot->releaseLazyTrigger(this);
+		lazyTriggerSlots.RemoveSingleSwap(index);
+	}
+
+	trackHydratedSlot(index, false);
+	if (slot->IsProxy())
+	{
+		proxySlotNr--;
+		keepProxyRecord(slot);
+	}
+
+	if (FOwnerSlots* counts = ownerSlots.Find(slot->GetOwner()))
+	{
+		if (counts->bAwake)
+			awakeOwnerSlotNr--;
+		if (--counts->SlotNr <= 0)
+			ownerSlots.Remove(slot->GetOwner());
+	}
+
+	registeredSlots[index] = FRegisteredSlot();
+	freeIndices.Add(index);
+	slot->registryIndex = INDEX_NONE;
+}
+
+void UItemSlotSubsystem::MarkSlotMoved(UItemSlot* slot)
+{
+	if (!slot || !registeredSlots.IsValidIndex(slot->registryIndex)) { return; }
+
+	FRegisteredSlot& entry = registeredSlots[slot->registryIndex];
+	if (entry.bMoved) { return; }
+
+	entry.bMoved = true;
+	movedSlots.Add(slot->registryIndex);
+}
+
+template<typename FFunc>
+void UItemSlotSubsystem::forEachSlotNear(const FVector& point, float radius, FFunc&& func)
+{
+	flushMovedSlots();
+
+	// Stamp entries instead of keeping a visited set, a slot spanning several cells is only tested once per query.
+	queryStamp++;
+
+	const FVector extent(radius);
+	const FIntVector minCell = toCell(point - extent);
+	const FIntVector maxCell = toCell(point + extent);
+	const float radiusSquared = radius * radius;
+
+	for (int32 x = minCell.X; x <= maxCell.X; x++)
+		for (int32 y = minCell.Y; y <= maxCell.Y; y++)
+			for (int32 z = minCell.Z; z <= maxCell.Z; z++)
+			{
+				const auto* cell = grid.Find(FIntVector(x, y, z));
+				if (!cell) { continue; }
+
+				for (int32 index : *cell)
+				{
+					FRegisteredSlot& entry = registeredSlots[index];
+					if (entry.QueryStamp == queryStamp) { continue; }
+					entry.QueryStamp = queryStamp;
+
+					if (entry.Slot.IsValid() && FMath::SphereAABBIntersection(point, radiusSquared, entry.Bounds))
+						func(entry);
+				}
+			}
+}
+
+void UItemSlotSubsystem::FindCompatibleSlotsNear(const FVector& point, float radius, const ASlotableActor* actor, FItemSlotCandidates& outAvailable, FItemSlotCandidates* outUnavailable)
+{
+	if (!actor) { return; }
+
+	ITEMSLOTS_SCOPE(FindCompatible);
+	forEachSlotNear(point, radius, [&](FRegisteredSlot& entry)
+		{
+			if (!entry.Slot->CheckForCompatibility(actor)) { return; }
+
+			if (entry.Slot->IsAvailableFor(actor))
+				outAvailable.Add(entry.Slot.Get());
+			else if (outUnavailable)
+				outUnavailable->Add(entry.Slot.Get());
+		});
+}
+
+void UItemSlotSubsystem::NotifySlotStateChanged(UItemSlot* slot, const FItemSlotNetState& previousNetState, const FItemSlotNetState& newNetState, uint8 event)
+{
+	INC_DWORD_STAT(STAT_ItemSlots_DirtySlots);
+	stateCommitCount++;
+
+	journal.Record(slot, previousNetState, newNetState, event, GetWorld()->GetTimeSeconds(), static_cast<uint32>(GFrameCounter));
+
+	const EItemSlotState previousState = previousNetState.State;
+	const EItemSlotState newState = newNetState.State;
+
+	if ((previousState == EItemSlotState::available) != (newState == EItemSlotState::available))
+		queueSlotEvent(slot, newState == EItemSlotState::available);
+
+	proxySlotNr += static_cast<int32>(newNetState.bProxy) - static_cast<int32>(previousNetState.bProxy);
+	if (UItemSlotSettings::Get()->bProxySlottedItems && registeredSlots.IsValidIndex(slot->registryIndex))
+		trackHydratedSlot(slot->registryIndex, newState == EItemSlotState::occupied && newNetState.Actor);
+
+	AActor* owner = slot->GetOwner();
+	if (!owner || !owner->HasAuthority() || !canManageDormancy(owner)) { return; }
+
+	const bool wasReserved = previousState == EItemSlotState::reserved;
+	const bool isReserved = newState == EItemSlotState::reserved;
+
+	if (isReserved && !wasReserved)
+	{
+		int32& activeSlots = ownerActiveSlots.FindOrAdd(owner);
+		if (activeSlots++ == 0)
+			setOwnerDormancy(owner, DORM_Awake);
+	}
+	else if (wasReserved && !isReserved)
+	{
+		int32* activeSlots = ownerActiveSlots.Find(owner);
+		if (activeSlots && --(*activeSlots) <= 0)
+		{
+			// The last change still goes out before the channel turns dormant.
+			ownerActiveSlots.Remove(owner);
+			setOwnerDormancy(owner, DORM_DormantAll);
+		}
+	}
+	else if (deferredFlushOwners)
+		deferredFlushOwners->Add(owner);
+	else
+		owner->FlushNetDormancy();
+}
+
+int32 UItemSlotSubsystem::ApplyLoadout(TConstArrayView<FItemSlotLoadoutEntry> entries, TArray<EItemSlotLoadoutResult>& outResults)
+{
+	ITEMSLOTS_SCOPE(ApplyLoadout);
+	outResults.Reset(entries.Num());
+
+	const bool proxies = UItemSlotSettings::Get()->bProxySlottedItems;
+	TSet<UItemSlot*> usedSlots;
+	TSet<AActor*> touchedOwners;
+	deferredFlushOwners = &touchedOwners;
+
+	int32 slottedNr = 0;
+	for (const FItemSlotLoadoutEntry& entry : entries)
+	{
+		EItemSlotLoadoutResult& result = outResults.Add_GetRef(EItemSlotLoadoutResult::Slotted);
+		UItemSlot* slot = entry.Slot;
+
+		if (!slot || !slot->GetOwner() || !slot->GetOwner()->HasAuthority() || !registeredSlots.IsValidIndex(slot->registryIndex))
+		{
+			result = EItemSlotLoadoutResult::InvalidSlot;
+			continue;
+		}
+
+		bool alreadyUsed = false;
+		usedSlots.Add(slot, &alreadyUsed);
+		if (alreadyUsed || slot->SlotState() != EItemSlotState::available)
+		{
+			result = EItemSlotLoadoutResult::SlotUnavailable;
+			continue;
+		}
+
+		UClass* actorClass = entry.Actor ? entry.Actor->GetClass() : entry.ActorClass.Get();
+		if (!actorClass || !slot->acceptsClass(actorClass))
+		{
+			result = EItemSlotLoadoutResult::Incompatible;
+			continue;
+		}
+
+		ASlotableActor* actor = entry.Actor;
+		if (actor && actor->currentGripState != EItemGripState::loose)
+		{
+			result = EItemSlotLoadoutResult::ActorBusy;
+			continue;
+		}
+
+		bool inserted;
+		if (!actor && proxies)
+		{
+			// Proxies need no actor, it is only spawned once a motion controller comes near.
+			inserted = slot->insertProxy(actorClass);
+		}
+		else
+		{
+			const bool spawned = !actor;
+			if (spawned)
+				actor = spawnSlottedActor(actorClass, slot);
+			if (!actor)
+			{
+				result = EItemSlotLoadoutResult::SpawnFailed;
+				continue;
+			}
+
+			inserted = slot->insertActor(actor);
+			if (inserted)
+				actor->setResidingSlot(slot);
+			else if (spawned)
+				actor->Destroy();
+		}
+
+		if (!inserted)
+		{
+			result = EItemSlotLoadoutResult::SlotUnavailable;
+			continue;
+		}
+
+		touchedOwners.Add(slot->GetOwner());
+		slottedNr++;
+	}
+
+	deferredFlushOwners = nullptr;
+
+	// One flush and net update per owner, so the whole loadout goes out together.
+	for (AActor* owner : touchedOwners)
+	{
+		owner->FlushNetDormancy();
+		owner->ForceNetUpdate();
+	}
+
+	UE_LOG(LogItemSlots, Verbose, TEXT("Loadout: %d of %d entries slotted, %d slot owner(s)"), slottedNr, entries.Num(), touchedOwners.Num());
+	return slottedNr;
+}
+
+void UItemSlotSubsystem::ReplayTransition(UItemSlot* slot, EItemSlotState state, AActor* actor, EControllerHand handSide, bool bProxy, int32 classIndex)
+{
+	if (!slot) { return; }
+
+	FItemSlotNetState replayedState;
+	replayedState.State = state;
+	if (state != EItemSlotState::available)
+	{
+		if (bProxy)
+			actor = nullptr;
+		replayedState.bProxy = bProxy;
+		replayedState.Actor = actor;
+		replayedState.HandSide = handSide;
+		replayedState.ClassIndex = classIndex == INDEX_NONE && actor ? slot->acceptedIndexFor(actor->GetClass()) : classIndex;
+	}
+	slot->commitNetState(replayedState, FItemSlotJournalEntry::DirectCommit);
+}
+
+bool UItemSlotSubsystem::ReplayEvent(UItemSlot* slot, EItemSlotEvent event, ASlotableActor* actor, EControllerHand handSide)
+{
+	return slot && slot->replayEvent(event, actor, handSide);
+}
+
+void UItemSlotSubsystem::queueSlotEvent(UItemSlot* slot, bool available)
+{
+	if (!registeredSlots.IsValidIndex(slot->registryIndex)) { return; }
+
+	pendingSlotEvents.Add({ slot->registryIndex, available });
+}
+
+void UItemSlotSubsystem::dispatchSlotEvents()
+{
+	if (pendingSlotEvents.Num() == 0) { return; }
+
+	ITEMSLOTS_SCOPE(DispatchEvents);
+
+	// Handlers may change slot states again, those changes are queued for the next frame.
+	Swap(pendingSlotEvents, dispatchingSlotEvents);
+
+	// By index, handlers that unregister a slot clear its remaining events in place.
+	for (int32 i = 0; i < dispatchingSlotEvents.Num(); i++)
+	{
+		const FSlotEvent event = dispatchingSlotEvents[i];
+		UItemSlot* slot = registeredSlots.IsValidIndex(event.Index) ? registeredSlots[event.Index].Slot.Get() : nullptr;
+		if (!slot) { continue; }
+
+		INC_DWORD_STAT(STAT_ItemSlots_SlotEvents);
+		if (event.bAvailable)
+			slot->OnAvailable.Broadcast(slot);
+		else
+			slot->OnOccupied.Broadcast(slot);
+	}
+	dispatchingSlotEvents.Reset();
+}
+
+UStaticMeshComponent* UItemSlotSubsystem::BorrowPreviewComponent(USceneComponent* attachTo)
+{
+	UStaticMeshComponent* component = previewPool.Num() > 0 ? previewPool.Pop().Get() : createPreviewComponent();
+	if (component && attachTo)
+		component->AttachToComponent(attachTo, FAttachmentTransformRules::KeepWorldTransform);
+
+	return component;
+}
+
+void UItemSlotSubsystem::ReturnPreviewComponent(UStaticMeshComponent* component)
+{
+	if (!component) { return; }
+
+	component->SetVisibility(false);
+	component->SetStaticMesh(nullptr);
+	component->EmptyOverrideMaterials();
+	component->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
+	previewPool.Add(component);
+}
+
+UStaticMeshComponent* UItemSlotSubsystem::createPreviewComponent()
+{
+	AWorldSettings* worldSettings = GetWorld()->GetWorldSettings();
+	if (!worldSettings) { return nullptr; }
+
+	UStaticMeshComponent* component = NewObject<UStaticMeshComponent>(worldSettings, NAME_None, RF_Transient);
+	component->SetGenerateOverlapEvents(false);
+	component->SetSimulatePhysics(false);
+	component->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	component->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
+	component->SetUsingAbsoluteScale(true);
+	component->SetCastShadow(false);
+	component->SetVisibility(false);
+	component->RegisterComponent();
+
+	previewComponentNr++;
+	return component;
+}
+
+void UItemSlotSubsystem::QueueSlotSetup(UItemSlot* slot)
+{
+	if (!slot) { return; }
+
+	if (pendingSetups.Num() == 0)
+		setupBatch = FSetupBatch();
+	pendingSetups.Add(slot);
+}
+
+void UItemSlotSubsystem::QueueNetObjectFilter(AActor* actor)
+{
+#if UE_WITH_IRIS
+	if (actor)
+		pendingFilterActors.AddUnique(actor);
+#endif
+}
+
+void UItemSlotSubsystem::assignNetObjectFilters()
+{
+#if UE_WITH_IRIS
+	for (int32 i = pendingFilterActors.Num() - 1; i >= 0; i--)
+	{
+		bool retry = false;
+		UItemSlotNetObjectFilter::AddActor(pendingFilterActors[i].Get(), retry);
+		if (!retry)
+			pendingFilterActors.RemoveAtSwap(i);
+	}
+#endif
+}
+
+void UItemSlotSubsystem::runPendingSetups()
+{
+	if (pendingSetups.Num() == 0) { return; }
+
+	ITEMSLOTS_SCOPE(DeferredSetup);
+	const double budgetSeconds = UItemSlotSettings::Get()->SlotSetupBudgetMs / 1000.0;
+	const double start = FPlatformTime::Seconds();
+
+	// At least one per frame, so a zero budget still gets through the queue.
+	int32 doneNr = 0;
+	while (doneNr < pendingSetups.Num())
+	{
+		UItemSlot* slot = pendingSetups[doneNr++].Get();
+		if (!slot) { continue; }
+
+		slot->finishSetup();
+		if (FPlatformTime::Seconds() - start >= budgetSeconds) { break; }
+	}
+	pendingSetups.RemoveAt(0, doneNr, false);
+
+	const double frameMs = (FPlatformTime::Seconds() - start) * 1000.0;
+	setupBatch.SlotNr += doneNr;
+	setupBatch.FrameNr++;
+	setupBatch.TotalMs += frameMs;
+	setupBatch.WorstFrameMs = FMath::Max(setupBatch.WorstFrameMs, frameMs);
+	SET_DWORD_STAT(STAT_ItemSlots_PendingSetups, pendingSetups.Num());
+
+	if (pendingSetups.Num() > 0) { return; }
+
+	// Done. Without the budget TotalMs would have been one frame, WorstFrameMs is what the load hitch is now.
+	SET_FLOAT_STAT(STAT_ItemSlots_SetupTotalMs, setupBatch.TotalMs);
+	SET_FLOAT_STAT(STAT_ItemSlots_SetupWorstFrameMs, setupBatch.WorstFrameMs);
+	UE_LOG(LogItemSlots, Log, TEXT("Set up %d slot(s) over %d frame(s): %.2f ms in total, %.2f ms in the worst frame"),
+		setupBatch.SlotNr, setupBatch.FrameNr, setupBatch.TotalMs, setupBatch.WorstFrameMs);
+}
+
+UShapeComponent* UItemSlotSubsystem::BorrowTrigger(bool box)
+{
+	TArray<TObjectPtr<UShapeComponent>>& pool = box ? boxTriggerPool : sphereTriggerPool;
+	if (pool.Num() > 0)
+		return pool.Pop(false);
+
+	AWorldSettings* worldSettings = GetWorld()->GetWorldSettings();
+	if (!worldSettings) { return nullptr; }
+
+	UShapeComponent* trigger;
+	if (box)
+		trigger = NewObject<UBoxComponent>(worldSettings, NAME_None, RF_Transient);
+	else
+		trigger = NewObject<USphereComponent>(worldSettings, NAME_None, RF_Transient);
+
+	trigger->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	trigger->SetVisibility(false);
+	trigger->RegisterComponent();
+	return trigger;
+}
+
+void UItemSlotSubsystem::ReturnTrigger(UShapeComponent* trigger)
+{
+	if (!trigger) { return; }
+
+	// Disabling collision ends the current overlaps, gripped actors drop the slot like they would on leaving its trigger.
+	trigger->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	trigger->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
+
+	if (trigger->IsA<UBoxComponent>())
+		boxTriggerPool.Add(trigger);
+	else
+		sphereTriggerPool.Add(trigger);
+}
+
+void UItemSlotSubsystem::updateLazyTriggers()
+{
+	const UItemSlotSettings* settings = UItemSlotSettings::Get();
+	if (!settings->bLazySlotTriggers) { return; }
+
+	ITEMSLOTS_SCOPE(LazyTriggerUpdate);
+	const double now = GetWorld()->GetTimeSeconds();
+
+	for (const TWeakObjectPtr<ASlotableActor>& gripper : grippers)
+	{
+		const ASlotableActor* actor = gripper.Get();
+		const USphereComponent* collider = actor ? actor->ColliderComponent : nullptr;
+		if (!collider) { continue; }
+
+		lazyTriggerCandidates.Reset();
+		FindCompatibleSlotsNear(collider->GetComponentLocation(), collider->GetScaledSphereRadius() + settings->LazyTriggerActivationRadius, actor, lazyTriggerCandidates, &lazyTriggerCandidates);
+
+		for (UItemSlot* slot : lazyTriggerCandidates)
+		{
+			if (slot->UsesSpatialRegistryOnly()) { continue; }
+
+			FRegisteredSlot& entry = registeredSlots[slot->registryIndex];
+			entry.LastTriggerUseTime = now;
+
+			if (!slot->bLazyTrigger && slot->acquireLazyTrigger(this))
+				lazyTriggerSlots.Add(slot->registryIndex);
+		}
+	}
+
+	for (int32 i = lazyTriggerSlots.Num() - 1; i >= 0; i--)
+	{
+		FRegisteredSlot& entry = registeredSlots[lazyTriggerSlots[i]];
+		if (now - entry.LastTriggerUseTime < settings->LazyTriggerReleaseCooldown) { continue; }
+
+		if (UItemSlot* slot = entry.Slot.Get())
+			slot->releaseLazyTrigger(this);
+		lazyTriggerSlots.RemoveAtSwap(i);
+	}
+
+	SET_DWORD_STAT(STAT_ItemSlots_LazyTriggers, lazyTriggerSlots.Num());
+}
+
+void UItemSlotSubsystem::trackHydratedSlot(int32 index, bool hydrated)
+{
+	FRegisteredSlot& entry = registeredSlots[index];
+	if (entry.bHydrated == hydrated) { return; }
+
+	entry.bHydrated = hydrated;
+	if (hydrated)
+	{
+		// Freshly slotted items stay actors for the dehydrate delay, the hand that put them there may still be near.
+		entry.LastHandNearTime = GetWorld()->GetTimeSeconds();
+		hydratedSlots.Add(index);
+	}
+	else
+		hydratedSlots.RemoveSingleSwap(index);
+}
+
+void UItemSlotSubsystem::updateProxies()
+{
+	const UItemSlotSettings* settings = UItemSlotSettings::Get();
+	if (!settings->bProxySlottedItems) { return; }
+
+	ITEMSLOTS_SCOPE(ProxyUpdate);
+	UWorld* world = GetWorld();
+	const double now = world->GetTimeSeconds();
+
+	// Rehydrating spawns actors, which may register slots of their own. Collected first so the grid isn't changed while walked.
+	rehydrateSlots.Reset();
+	for (FConstPlayerControllerIterator it = world->GetPlayerControllerIterator(); it; ++it)
+	{
+		const APlayerController* controller = it->Get();
+		const APawn* pawn = controller ? controller->GetPawn() : nullptr;
+		if (!pawn) { continue; }
+
+		TInlineComponentArray<UGripMotionControllerComponent*> hands(pawn);
+		for (const UGripMotionControllerComponent* hand : hands)
+		{
+			forEachSlotNear(hand->GetComponentLocation(), settings->ProxyRehydrateRadius, [&](FRegisteredSlot& entry)
+				{
+					if (entry.Slot->SlotState() != EItemSlotState::occupied) { return; }
+
+					entry.LastHandNearTime = now;
+					if (entry.Slot->IsProxy())
+						rehydrateSlots.AddUnique(entry.Slot.Get());
+				});
+		}
+	}
+
+	for (UItemSlot* slot : rehydrateSlots)
+	{
+		if (slot->rehydrate(this))
+			INC_DWORD_STAT(STAT_ItemSlots_Rehydrations);
+	}
+
+	// Dehydrating takes the slot out of hydratedSlots, the swapped in entry was already visited.
+	for (int32 i = hydratedSlots.Num() - 1; i >= 0; i--)
+	{
+		FRegisteredSlot& entry = registeredSlots[hydratedSlots[i]];
+		if (now - entry.LastHandNearTime < settings->ProxyDehydrateDelay) { continue; }
+
+		UItemSlot* slot = entry.Slot.Get();
+		if (slot && slot->dehydrate(this)) { continue; }
+
+		// Nothing to dehydrate, stop tracking it until its state changes again.
+		entry.bHydrated = false;
+		hydratedSlots.RemoveAtSwap(i);
+	}
+
+	SET_DWORD_STAT(STAT_ItemSlots_ProxySlots, proxySlotNr);
+	SET_DWORD_STAT(STAT_ItemSlots_PooledProxyActors, proxyActorPool.Num());
+}
+
+ASlotableActor* UItemSlotSubsystem::AcquireProxyActor(TSubclassOf<ASlotableActor> actorClass, UItemSlot* slot)
+{
+	if (!actorClass || !slot) { return nullptr; }
+
+	ASlotableActor* actor = nullptr;
+	const int32 pooledIndex = proxyActorPool.IndexOfByPredicate([&](const ASlotableActor* pooled) { return IsValid(pooled) && pooled->GetClass() == actorClass; });
+	if (pooledIndex != INDEX_NONE)
+	{
+		actor = proxyActorPool[pooledIndex];
+		proxyActorPool.RemoveAtSwap(pooledIndex);
+
+		actor->SetActorTransform(slot->GetComponentTransform(), false, nullptr, ETeleportType::TeleportPhysics);
+		actor->SetOwner(slot->GetOwner());
+		actor->setPooled(false);
+	}
+	else
+		actor = spawnSlottedActor(actorClass, slot);
+
+	if (actor)
+		actor->setResidingSlot(slot);
+	return actor;
+}
+
+void UItemSlotSubsystem::ReleaseProxyActor(ASlotableActor* actor)
+{
+	if (!IsValid(actor)) { return; }
+
+	if (proxyActorPool.Num() >= UItemSlotSettings::Get()->ProxyActorPoolSize)
+	{
+		actor->Destroy();
+		return;
+	}
+
+	actor->setPooled(true);
+	proxyActorPool.Add(actor);
+}
+
+void UItemSlotSubsystem::keepProxyRecord(UItemSlot* slot)
+{
+	AActor* owner = slot->GetOwner();
+	UWorld* world = GetWorld();
+	if (!owner || !owner->HasAuthority() || !world || world->bIsTearingDown) { return; }
+
+	// Level placed owners come back with the same slot names when their level streams in again.
+	if (owner->IsNetStartupActor())
+	{
+		unregisteredProxyRecords.Add(FSoftObjectPath(slot), slot->proxyRecord);
+		return;
+	}
+
+	// Any other owner is gone for good. The occupant is left behind like an actor occupant would be.
+	ASlotableActor* actor = spawnSlottedActor(slot->proxyRecord.ActorClass, slot);
+	if (!actor) { return; }
+
+	actor->SetOwner(nullptr);
+	FMemoryReader reader(slot->proxyRecord.Data);
+	actor->SerializeProxyData(reader);
+}
+
+void UItemSlotSubsystem::restoreProxyRecord(UItemSlot* slot)
+{
+	if (unregisteredProxyRecords.Num() == 0) { return; }
+
+	FItemSlotProxyRecord record;
+	if (!unregisteredProxyRecords.RemoveAndCopyValue(FSoftObjectPath(slot), record)) { return; }
+
+	if (slot->SlotState() == EItemSlotState::available && slot->insertProxy(record.ActorClass))
+		slot->proxyRecord.Data = MoveTemp(record.Data);
+	else
+		UE_LOG(LogItemSlots, Warning, TEXT("%s came back occupied or no longer accepts its proxied %s, the proxy is dropped"), *slot->GetPathName(), *GetNameSafe(record.ActorClass));
+}
+
+ASlotableActor* UItemSlotSubsystem::spawnSlottedActor(UClass* actorClass, UItemSlot* slot)
+{
+	// Physics and collision are set before the actor is finished, so it never creates a simulating body.
+	const FTransform spawnTransform = slot->GetComponentTransform();
+	ASlotableActor* actor = GetWorld()->SpawnActorDeferred<ASlotableActor>(actorClass, spawnTransform, slot->GetOwner(), nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	if (!actor) { return nullptr; }
+
+	if (UPrimitiveComponent* root = Cast<UPrimitiveComponent>(actor->GetRootComponent()))
+	{
+		root->SetSimulatePhysics(false);
+		root->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	}
+	actor->FinishSpawning(spawnTransform);
+	return actor;
+}
+
+FItemSlotPreviewInstance UItemSlotSubsystem::AddPreviewInstance(UStaticMesh* mesh, UMaterialInterface* material, const FTransform& worldTransform)
+{
+	FItemSlotPreviewInstance instance;
+	if (!mesh || GetWorld()->GetNetMode() == NM_DedicatedServer) { return instance; }
+
+	instance.Batch = findOrAddPreviewBatch(mesh, material);
+	if (instance.Batch == INDEX_NONE) { return instance; }
+
+	FPreviewBatch& batch = previewBatches[instance.Batch];
+	if (batch.FreeInstances.Num() > 0)
+	{
+		instance.Instance = batch.FreeInstances.Pop();
+		batch.Component->UpdateInstanceTransform(instance.Instance, worldTransform, true, true);
+	}
+	else
+		instance.Instance = batch.Component->AddInstance(worldTransform, true);
+
+	return instance;
+}
+
+void UItemSlotSubsystem::UpdatePreviewInstance(const FItemSlotPreviewInstance& instance, const FTransform& worldTransform)
+{
+	if (!instance.IsValid() || !previewBatches.IsValidIndex(instance.Batch)) { return; }
+
+	previewBatches[instance.Batch].Component->UpdateInstanceTransform(instance.Instance, worldTransform, true, true);
+}
+
+void UItemSlotSubsystem::RemovePreviewInstance(FItemSlotPreviewInstance& instance)
+{
+	if (!instance.IsValid() || !previewBatches.IsValidIndex(instance.Batch)) { return; }
+
+	// Removing would shift the indices of later instances, a zero scaled instance isn't drawn and keeps every handle valid.
+	FPreviewBatch& batch = previewBatches[instance.Batch];
+	FTransform hiddenTransform;
+	batch.Component->GetInstanceTransform(instance.Instance, hiddenTransform, true);
+	hiddenTransform.SetScale3D(FVector::ZeroVector);
+	batch.Component->UpdateInstanceTransform(instance.Instance, hiddenTransform, true, true);
+	batch.FreeInstances.Add(instance.Instance);
+
+	instance = FItemSlotPreviewInstance();
+}
+
+bool UItemSlotSubsystem::IsPreviewInstanceOf(const FItemSlotPreviewInstance& instance, const UStaticMesh* mesh, const UMaterialInterface* material) const
+{
+	const int32* batchId = previewBatchIds.Find(TPair<const UStaticMesh*, const UMaterialInterface*>(mesh, material));
+	return instance.IsValid() && batchId && *batchId == instance.Batch;
+}
+
+int32 UItemSlotSubsystem::NumPreviewInstances(const UStaticMesh* mesh, const UMaterialInterface* material) const
+{
+	const int32* batchId = previewBatchIds.Find(TPair<const UStaticMesh*, const UMaterialInterface*>(mesh, material));
+	if (!batchId) { return 0; }
+
+	const FPreviewBatch& batch = previewBatches[*batchId];
+	return batch.Component->GetInstanceCount() - batch.FreeInstances.Num();
+}
+
+void UItemSlotSubsystem::ShowGhostPreviews(const ASlotableActor* actor)
+{
+	if (!actor || GetWorld()->GetNetMode() == NM_DedicatedServer) { return; }
+
+	HideGhostPreviews(actor);
+	TArray<FItemSlotPreviewInstance>& instances = ghostPreviews.Add(actor);
+
+	// Streamed in rather than loaded here, the ghosts show on the tick after it arrives.
+	const UItemSlotSettings* settings = UItemSlotSettings::Get();
+	UMaterialInterface* ghostMaterial = settings->GhostPreviewMaterial.Get();
+	if (!ghostMaterial && !settings->GhostPreviewMaterial.IsNull())
+	{
+		if (!ghostMaterialHandle.IsValid())
+			ghostMaterialHandle = previewStreamer.RequestAsyncLoad(settings->GhostPreviewMaterial.ToSoftObjectPath(), FStreamableDelegate::CreateUObject(this, &UItemSlotSubsystem::MarkGhostPreviewsDirty));
+		return;
+	}
+
+	forEachSlotNear(actor->GetActorLocation(), settings->GhostPreviewRadius, [&](FRegisteredSlot& entry)
+		{
+			if (!entry.Slot->CheckForCompatibility(actor) || !entry.Slot->IsAvailableFor(actor)) { return; }
+
+			// Meshes that are still streaming in show once onPreviewMeshLoaded marked the ghosts dirty.
+			const FSlotableActorVisuals* visuals = entry.Slot->findVisualsFor(actor->GetClass());
+			UStaticMesh* mesh = visuals ? RequestPreviewMesh(visuals->Mesh) : nullptr;
+			if (!mesh) { return; }
+
+			FItemSlotPreviewInstance instance = AddPreviewInstance(mesh, ghostMaterial, entry.Slot->getVisualsWorldTransform(*visuals));
+			if (instance.IsValid())
+				instances.Add(instance);
+		});
+}
+
+void UItemSlotSubsystem::MarkGhostPreviewsDirty()
+{
+	if (ghostPreviews.Num() > 0)
+		bGhostPreviewsDirty = true;
+}
+
+int32 UItemSlotSubsystem::NumGhostPreviews(const ASlotableActor* actor) const
+{
+	const TArray<FItemSlotPreviewInstance>* instances = ghostPreviews.Find(actor);
+	return instances ? instances->Num() : 0;
+}
+
+void UItemSlotSubsystem::refreshGhostPreviews()
+{
+	if (!bGhostPreviewsDirty) { return; }
+	bGhostPreviewsDirty = false;
+
+	TArray<const ASlotableActor*> actors;
+	for (auto it = ghostPreviews.CreateIterator(); it; ++it)
+	{
+		if (const ASlotableActor* actor = it.Key().Get())
+		{
+			actors.Add(actor);
+			continue;
+		}
+
+		for (FItemSlotPreviewInstance& instance : it.Value())
+			RemovePreviewInstance(instance);
+		it.RemoveCurrent();
+	}
+
+	for (const ASlotableActor* actor : actors)
+		ShowGhostPreviews(actor);
+}
+
+UStaticMesh* UItemSlotSubsystem::RequestPreviewMesh(const TSoftObjectPtr<UStaticMesh>& mesh, UItemSlot* waitingSlot)
+{
+	if (mesh.IsNull()) { return nullptr; }
+
+	const FSoftObjectPath path = mesh.ToSoftObjectPath();
+	if (const int32* index = residentPreviewMeshIndices.Find(path))
+	{
+		unlinkResidentPreviewMesh(*index);
+		linkNewestResidentPreviewMesh(*index);
+	}
+	else
+	{
+		int32 newIndex;
+		if (freeResidentPreviewMeshes.Num() > 0)
+			newIndex = freeResidentPreviewMeshes.Pop(false);
+		else
+			newIndex = residentPreviewMeshes.AddDefaulted();
+
+		FResidentPreviewMesh& resident = residentPreviewMeshes[newIndex];
+		resident.Path = path;
+		resident.Handle = previewStreamer.RequestAsyncLoad(path, FStreamableDelegate::CreateUObject(this, &UItemSlotSubsystem::onPreviewMeshLoaded, path));
+		residentPreviewMeshIndices.Add(path, newIndex);
+		linkNewestResidentPreviewMesh(newIndex);
+		INC_DWORD_STAT(STAT_ItemSlots_PreviewMeshRequests);
+
+		// Evicted meshes stay loaded as long as a preview still shows them.
+		const int32 capacity = FMath::Max(1, UItemSlotSettings::Get()->ResidentPreviewMeshes);
+		while (residentPreviewMeshIndices.Num() > capacity)
+		{
+			const int32 oldest = oldestResidentPreviewMesh;
+			unlinkResidentPreviewMesh(oldest);
+			residentPreviewMeshIndices.Remove(residentPreviewMeshes[oldest].Path);
+			residentPreviewMeshes[oldest] = FResidentPreviewMesh();
+			freeResidentPreviewMeshes.Add(oldest);
+		}
+	}
+	SET_DWORD_STAT(STAT_ItemSlots_ResidentPreviewMeshes, residentPreviewMeshIndices.Num());
+
+	UStaticMesh* loaded = mesh.Get();
+	if (!loaded && waitingSlot)
+		previewMeshWaiters.FindOrAdd(path).AddUnique(waitingSlot);
+	return loaded;
+}
+
+void UItemSlotSubsystem::unlinkResidentPreviewMesh(int32 index)
+{
+	FResidentPreviewMesh& resident = residentPreviewMeshes[index];
+	if (resident.Older != INDEX_NONE)
+		residentPreviewMeshes[resident.Older].Newer = resident.Newer;
+	else
+		oldestResidentPreviewMesh = resident.Newer;
+
+	if (resident.Newer != INDEX_NONE)
+		residentPreviewMeshes[resident.Newer].Older = resident.Older;
+	else
+		newestResidentPreviewMesh = resident.Older;
+
+	resident.Older = INDEX_NONE;
+	resident.Newer = INDEX_NONE;
+}
+
+void UItemSlotSubsystem::linkNewestResidentPreviewMesh(int32 index)
+{
+	FResidentPreviewMesh& resident = residentPreviewMeshes[index];
+	resident.Older = newestResidentPreviewMesh;
+	resident.Newer = INDEX_NONE;
+
+	if (newestResidentPreviewMesh != INDEX_NONE)
+		residentPreviewMeshes[newestResidentPreviewMesh].Newer = index;
+	else
+		oldestResidentPreviewMesh = index;
+	newestResidentPreviewMesh = index;
+}
+
+void UItemSlotSubsystem::onPreviewMeshLoaded(FSoftObjectPath path)
+{
+	MarkGhostPreviewsDirty();
+
+	TArray<TWeakObjectPtr<UItemSlot>> waiters;
+	if (!previewMeshWaiters.RemoveAndCopyValue(path, waiters)) { return; }
+
+	for (const TWeakObjectPtr<UItemSlot>& slot : waiters)
+	{
+		if (UItemSlot* waitingSlot = slot.Get())
+			waitingSlot->refreshPreview();
+	}
+}
+
+void UItemSlotSubsystem::PrefetchPreviewMeshes(const ASlotableActor* actor)
+{
+	if (!actor || GetWorld()->GetNetMode() == NM_DedicatedServer) { return; }
+
+	RequestPreviewMesh(actor->GetPreviewMesh());
+
+	const USphereComponent* collider = actor->ColliderComponent;
+	if (!collider) { return; }
+
+	prefetchSlots.Reset();
+	FindCompatibleSlotsNear(collider->GetComponentLocation(), collider->GetScaledSphereRadius() + UItemSlotSettings::Get()->PreviewPrefetchRadius, actor, prefetchSlots, &prefetchSlots);
+
+	for (const UItemSlot* slot : prefetchSlots)
+	{
+		if (const FSlotableActorVisuals* visuals = slot->findVisualsFor(actor->GetClass()))
+			RequestPreviewMesh(visuals->Mesh);
+	}
+}
+
+void UItemSlotSubsystem::HideGhostPreviews(const ASlotableActor* actor)
+{
+	TArray<FItemSlotPreviewInstance> instances;
+	if (!ghostPreviews.RemoveAndCopyValue(actor, instances)) { return; }
+
+	for (FItemSlotPreviewInstance& instance : instances)
+		RemovePreviewInstance(instance);
+}
+
+int32 UItemSlotSubsystem::findOrAddPreviewBatch(UStaticMesh* mesh, UMaterialInterface* material)
+{
+	const TPair<const UStaticMesh*, const UMaterialInterface*> key(mesh, material);
+	if (const int32* batchId = previewBatchIds.Find(key))
+		return *batchId;
+
+	AWorldSettings* worldSettings = GetWorld()->GetWorldSettings();
+	if (!worldSettings) { return INDEX_NONE; }
+
+	UInstancedStaticMeshComponent* component = NewObject<UInstancedStaticMeshComponent>(worldSettings, NAME_None, RF_Transient);
+	component->SetMobility(EComponentMobility::Movable);
+	component->SetStaticMesh(mesh);
+	if (material)
+		component->SetMaterial(0, material);
+	component->SetGenerateOverlapEvents(false);
+	component->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	component->SetCastShadow(false);
+	component->RegisterComponent();
+
+	const int32 batchId = previewBatches.AddDefaulted();
+	previewBatches[batchId].Component = component;
+	previewBatchComponents.Add(component);
+	previewBatchIds.Add(key, batchId);
+	return batchId;
+}
+
+bool UItemSlotSubsystem::canManageDormancy(const AActor* owner) const
+{
+	if (!UItemSlotSettings::Get()->bManageSlotOwnerDormancy) { return false; }
+
+	// Anything that moves on its own keeps replicating normally.
+	return !owner->IsA<APawn>() && !owner->IsReplicatingMovement();
+}
+
+void UItemSlotSubsystem::setOwnerDormancy(AActor* owner, ENetDormancy dormancy)
+{
+	owner->SetNetDormancy(dormancy);
+
+	FOwnerSlots* counts = ownerSlots.Find(owner);
+	const bool awake = dormancy <= DORM_Awake;
+	if (!counts || counts->bAwake == awake) { return; }
+
+	counts->bAwake = awake;
+	awakeOwnerSlotNr += awake ? counts->SlotNr : -counts->SlotNr;
+}
+
+void UItemSlotSubsystem::updateReplicationStats()
+{
+	SET_DWORD_STAT(STAT_ItemSlots_ComparedSlots, awakeOwnerSlotNr);
+	SET_DWORD_STAT(STAT_ItemSlots_ActiveGrippers, grippers.Num());
+	CSV_CUSTOM_STAT(ItemSlots, ActiveGrippers, grippers.Num(), ECsvCustomStatOp::Set);
+}
+
+void UItemSlotSubsystem::updateRateStats(float deltaTime)
+{
+	rateWindowTime += deltaTime;
+	if (rateWindowTime < 1.0f) { return; }
+
+	const float reservationsPerSecond = (reservationSwitchCount - rateWindowReservations) / rateWindowTime;
+	const float rpcsPerSecond = (rpcCount - rateWindowRpcs) / rateWindowTime;
+	SET_FLOAT_STAT(STAT_ItemSlots_ReservationsPerSecond, reservationsPerSecond);
+	SET_FLOAT_STAT(STAT_ItemSlots_RpcsPerSecond, rpcsPerSecond);
+	CSV_CUSTOM_STAT(ItemSlots, ReservationsPerSecond, reservationsPerSecond, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(ItemSlots, RpcsPerSecond, rpcsPerSecond, ECsvCustomStatOp::Set);
+
+	const uint64 windowPredictions = predictionCount - rateWindowPredictions;
+	if (windowPredictions > 0)
+	{
+		const float mispredictRate = float(mispredictionCount - rateWindowMispredictions) / windowPredictions;
+		SET_FLOAT_STAT(STAT_ItemSlots_MispredictRate, mispredictRate);
+		CSV_CUSTOM_STAT(ItemSlots, MispredictRate, mispredictRate, ECsvCustomStatOp::Set);
+	}
+
+	rateWindowTime = 0.0f;
+	rateWindowReservations = reservationSwitchCount;
+	rateWindowRpcs = rpcCount;
+	rateWindowPredictions = predictionCount;
+	rateWindowMispredictions = mispredictionCount;
+}
+
+void UItemSlotSubsystem::RegisterGripper(ASlotableActor* actor)
+{
+	if (actor)
+		grippers.AddUnique(actor);
+}
+
+void UItemSlotSubsystem::UnregisterGripper(ASlotableActor* actor)
+{
+	grippers.RemoveSwap(actor);
+}
+
+void UItemSlotSubsystem::RegisterPredictingGripper(ASlotableActor* actor)
+{
+	if (actor)
+		predictingGrippers.AddUnique(actor);
+}
+
+void UItemSlotSubsystem::UnregisterPredictingGripper(ASlotableActor* actor)
+{
+	predictingGrippers.RemoveSwap(actor);
+}
+
+void UItemSlotSubsystem::predictReservations()
+{
+	for (const TWeakObjectPtr<ASlotableActor>& actor : predictingGrippers)
+	{
+		if (actor.IsValid())
+			actor->updatePredictedReservation();
+	}
+}
+
+void UItemSlotSubsystem::solveNearestSlots()
+{
+	grippers.RemoveAllSwap([](const TWeakObjectPtr<ASlotableActor>& gripper) { return !gripper.IsValid(); });
+
+	const int32 gripperNr = grippers.Num();
+	if (gripperNr == 0) { return; }
+
+	ITEMSLOTS_SCOPE(Solve);
+
+	// Registry-only slots have no overlap events, their candidates are synced before solving.
+	for (int32 g = gripperNr - 1; g >= 0; g--)
+		grippers[g]->refreshRegistrySlots();
+
+	candidateX.Reset();
+	candidateY.Reset();
+	candidateZ.Reset();
+	candidateSlots.Reset();
+	gripperCandidateEnd.Reset();
+	gripperCandidateEnd.AddUninitialized(gripperNr);
+
+	for (int32 g = 0; g < gripperNr; g++)
+	{
+		const ASlotableActor* gripper = grippers[g].Get();
+		for (UItemSlot* slot : gripper->currentlyAvailable_Slots)
+		{
+			// A slot still waiting for its trigger would never see the overlap end, it can't be reserved before that.
+			if (!slot || !slot->IsReady() || !slot->IsAvailableFor(gripper)) { continue; }
+
+			const FVector location = slot->GetComponentLocation();
+			candidateX.Add(location.X);
+			candidateY.Add(location.Y);
+			candidateZ.Add(location.Z);
+			candidateSlots.Add(slot);
+		}
+		gripperCandidateEnd[g] = candidateSlots.Num();
+	}
+
+	SET_DWORD_STAT(STAT_ItemSlots_CandidateSlots, candidateSlots.Num());
+	CSV_CUSTOM_STAT(ItemSlots, CandidateSlots, candidateSlots.Num(), ECsvCustomStatOp::Set);
+
+	candidateDistances.Reset();
+	candidateDistances.AddUninitialized(candidateSlots.Num());
+
+	// Plain float loops over contiguous ranges, the compiler is free to vectorize these.
+	int32 rangeStart = 0;
+	for (int32 g = 0; g < gripperNr; g++)
+	{
+		const FVector gripperLocation = grippers[g]->GetActorLocation();
+		const float gx = gripperLocation.X;
+		const float gy = gripperLocation.Y;
+		const float gz = gripperLocation.Z;
+		const int32 rangeEnd = gripperCandidateEnd[g];
+
+		for (int32 i = rangeStart; i < rangeEnd; i++)
+		{
+			const float dx = candidateX[i] - gx;
+			const float dy = candidateY[i] - gy;
+			const float dz = candidateZ[i] - gz;
+			candidateDistances[i] = dx * dx + dy * dy + dz * dz;
+		}
+		rangeStart = rangeEnd;
+	}
+
+	rangeStart = 0;
+	for (int32 g = 0; g < gripperNr; g++)
+	{
+		const int32 rangeEnd = gripperCandidateEnd[g];
+
+		UItemSlot* nearest = nullptr;
+		float nearestDistance = TNumericLimits<float>::Max();
+		for (int32 i = rangeStart; i < rangeEnd; i++)
+		{
+			if (candidateDistances[i] < nearestDistance)
+			{
+				nearestDistance = candidateDistances[i];
+				nearest = candidateSlots[i];
+			}
+		}
+		rangeStart = rangeEnd;
+
+		// Applying a slot runs gameplay events, which may have destroyed a later gripper.
+		if (ASlotableActor* gripper = grippers[g].Get())
+			gripper->applyNearestSlot(nearest);
+	}
+}
+
+int32 UItemSlotSubsystem::RegisterSlotableClass(UClass* actorClass)
+{
+	if (!actorClass) { return INDEX_NONE; }
+
+	if (const int32* existingId = slotableClassIds.Find(actorClass))
+		return *existingId;
+
+	const int32 classId = slotableClasses.Add(actorClass);
+	slotableClassIds.Add(actorClass, classId);
+
+	for (const FRegisteredSlot& entry : registeredSlots)
+	{
+		if (entry.Slot)
+			entry.Slot->updateCompatibilityBit(classId, actorClass);
+	}
+
+	return classId;
+}
+
+FIntVector UItemSlotSubsystem::toCell(const FVector& location) const
+{
+	return FIntVector(
+		FMath::FloorToInt(location.X / cellSize),
+		FMath::FloorToInt(location.Y / cellSize),
+		FMath::FloorToInt(location.Z / cellSize));
+}
+
+void UItemSlotSubsystem::addToCells(int32 index)
+{
+	FRegisteredSlot& entry = registeredSlots[index];
+	entry.Bounds = entry.Slot->GetTriggerBounds();
+	entry.MinCell = toCell(entry.Bounds.Min);
+	entry.MaxCell = toCell(entry.Bounds.Max);
+
+	for (int32 x = entry.MinCell.X; x <= entry.MaxCell.X; x++)
+		for (int32 y = entry.MinCell.Y; y <= entry.MaxCell.Y; y++)
+			for (int32 z = entry.MinCell.Z; z <= entry.MaxCell.Z; z++)
+				grid.FindOrAdd(FIntVector(x, y, z)).Add(index);
+}
+
+void UItemSlotSubsystem::removeFromCells(int32 index)
+{
+	const FRegisteredSlot& entry = registeredSlots[index];
+
+	for (int32 x = entry.MinCell.X; x <= entry.MaxCell.X; x++)
+		for (int32 y = entry.MinCell.Y; y <= entry.MaxCell.Y; y++)
+			for (int32 z = entry.MinCell.Z; z <= entry.MaxCell.Z; z++)
+			{
+				const FIntVector key(x, y, z);
+				auto* cell = grid.Find(key);
+				if (!cell) { continue; }
+
+				cell->RemoveSwap(index);
+				if (cell->Num() == 0)
+					grid.Remove(key);
+			}
+}
+
+void UItemSlotSubsystem::flushMovedSlots()
+{
+	for (int32 index : movedSlots)
+	{
+		FRegisteredSlot& entry = registeredSlots[index];
+		if (!entry.Slot || !entry.bMoved) { continue; }
+
+		entry.bMoved = false;
+
+		const FBox newBounds = entry.Slot->GetTriggerBounds();
+		if (toCell(newBounds.Min) == entry.MinCell && toCell(newBounds.Max) == entry.MaxCell)
+		{
+			entry.Bounds = newBounds;
+			continue;
+		}
+
+		removeFromCells(index);
+		addToCells(index);
+	}
+	movedSlots.Reset();
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GItemSlotCountSlotableActorsCommand(
+	TEXT("DVREE.Slots.CountSlotableActors"),
+	TEXT("Logs how many ASlotableActors exist in this world and how many of them are pooled (hidden on clients). On a client, pooled proxy actors of the server must not show up."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& args, UWorld* world)
+		{
+			if (!world) { return; }
+
+			int32 actorNr = 0;
+			int32 pooledNr = 0;
+			for (TActorIterator<ASlotableActor> it(world); it; ++it)
+			{
+				actorNr++;
+				if (it->IsPooled() || (world->GetNetMode() == NM_Client && it->IsHidden()))
+					pooledNr++;
+			}
+
+			const UItemSlotSubsystem* registry = UItemSlotSubsystem::Get(world);
+			UE_LOG(LogItemSlots, Log, TEXT("%s: %d slotable actor(s), %d pooled, %d proxy slot(s)"),
+				world->GetNetMode() == NM_Client ? TEXT("Client") : TEXT("Server"), actorNr, pooledNr, registry ? registry->NumProxySlots() : 0);
+		}));
@@ -4,16 +4,43 @@
 #include "GripMotionControllerComponent.h"
 #include "Net/UnrealNetwork.h"
 #include "ItemGripState.h"
+#include "ItemSlotSubsystem.h"
+#include "ItemSlotSettings.h"
+#include "ItemSlotStats.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "ItemSlotReplicationGraph.h"
+#include "Engine/NetDriver.h"
 
 ASlotableActor::ASlotableActor(const FObjectInitializer& ObjectInitializer) : AGrippableActor(ObjectInitializer)
 {
 	bReplicates = true;
 }
 
+void ASlotableActor::PostLoad()
+{
+	Super::PostLoad();
+
+#if WITH_EDITOR
+	// Migrates the hard preview reference, the next save drops it.
+	if (PreviewMesh && SoftPreviewMesh.IsNull())
+	{
+		SoftPreviewMesh = PreviewMesh.Get();
+		PreviewMesh = nullptr;
+	}
+#endif
+}
+
 void ASlotableActor::BeginPlay()
 {
 	Super::BeginPlay();
 
+	if (UItemSlotSubsystem* registry = UItemSlotSubsystem::Get(this))
+	{
+		slotClassIndex = registry->RegisterSlotableClass(GetClass());
+		if (HasAuthority())
+			registry->QueueNetObjectFilter(this);
+	}
+
 	setupColliderRef();
 	if (ColliderComponent)
 	{
@@ -21,19 +48,17 @@ void ASlotableActor::BeginPlay()
 		ColliderComponent->OnComponentEndOverlap.AddDynamic(this, &ASlotableActor::checkForSlotOnOverlapEnd);
 	}
 }
-void ASlotableActor::Tick(float deltaSeconds)
+void ASlotableActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	Super::Tick(deltaSeconds);
-
-	if (currentlyAvailable_Slots.Num() > 1 && currentGripState == EItemGripState::gripped)
+	if (UItemSlotSubsystem* registry = UItemSlotSubsystem::Get(this))
 	{
-		if (!HasAuthority()) { return; }
-		refreshNearestSlot();
+		registry->UnregisterGripper(this);
+		registry->HideGhostPreviews(this);
+		registry->UnregisterPredictingGripper(this);
 	}
-}
+	clearPredictedReservation();
+	unsubscribeFromAllSlots();
 
-void ASlotableActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
-{
 	DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
 	Super::EndPlay(EndPlayReason);
 }
@@ -54,16 +79,19 @@ void ASlotableActor::Server_Grip_Implementation(UGripMotionControllerComponent*
 	rootAsPrimitiveComponent->SetCollisionResponseToChannel(ECollisionChannel::ECC_GameTraceChannel1, ECollisionResponse::ECR_Overlap);
 
 	currentGrippingController = GrippingController;
+	MARK_PROPERTY_DIRTY_FROM_NAME(ASlotableActor, currentGrippingController, this);
 
 	if (currentGrippingController->MotionSource == "left")
 		handSide = EControllerHand::Left;
 	else
 		handSide = EControllerHand::Right;
+	MARK_PROPERTY_DIRTY_FROM_NAME(ASlotableActor, handSide, this);
 
 	if (currentGripState == EItemGripState::slotted)
 	{
 		current_ResidingSlot->RemoveSlotableActor(this);
 		current_ResidingSlot = nullptr;
+		MARK_PROPERTY_DIRTY_FROM_NAME(ASlotableActor, current_ResidingSlot, this);
 	}
 
 	auto controllerOwner = GrippingController->GetOwner();
@@ -71,7 +99,23 @@ void ASlotableActor::Server_Grip_Implementation(UGripMotionControllerComponent*
 	SetOwner(controllerOwner);
 
 	currentGripState = EItemGripState::gripped;
+	MARK_PROPERTY_DIRTY_FROM_NAME(ASlotableActor, currentGripState, this);
 	manualFindAvailableSlotsCall();
+
+	UItemSlotSubsystem* registry = UItemSlotSubsystem::Get(this);
+	if (!registry) { return; }
+
+	registry->PrefetchPreviewMeshes(this);
+
+	const bool locallyControlled = GrippingController->IsLocallyControlled();
+	if (UItemSlotSettings::Get()->bShowGhostPreviewsWhileGripped && locallyControlled)
+		registry->ShowGhostPreviews(this);
+
+	if (UItemSlotSettings::Get()->bClientPredictedReservations && locallyControlled && !HasAuthority())
+		registry->RegisterPredictingGripper(this);
+
+	if (HasAuthority())
+		registry->RegisterGripper(this);
 }
 
 void ASlotableActor::OnGripRelease_Implementation(UGripMotionControllerComponent* ReleasingController, const FBPActorGripInformation& GripInformation, bool bWasSocketed)
@@ -85,15 +129,23 @@ void ASlotableActor::OnGripRelease_Implementation(UGripMotionControllerComponent
 
 void ASlotableActor::Server_GripRelease_Implementation(UGripMotionControllerComponent* ReleasingController)
 {
+	if (UItemSlotSubsystem* registry = UItemSlotSubsystem::Get(this))
+	{
+		registry->UnregisterGripper(this);
+		registry->HideGhostPreviews(this);
+		registry->UnregisterPredictingGripper(this);
+	}
+	clearPredictedReservation();
+
 	if (currentNearestSlot != nullptr)
 	{
-		unsubscribeFromOccupiedEvent(currentNearestSlot);
 		currentGripState = EItemGripState::slotted;
 
 		if (HasAuthority())
 			currentNearestSlot->ReceiveActorInstigator(this);
 
 		current_ResidingSlot = currentNearestSlot;
+		MARK_PROPERTY_DIRTY_FROM_NAME(ASlotableActor, current_ResidingSlot, this);
 	}
 	else
 	{
@@ -104,47 +156,130 @@ void ASlotableActor::Server_GripRelease_Implementation(UGripMotionControllerComp
 		rootAsPrimitiveComponent->SetCollisionProfileName("BlockAllDynamic");
 		rootAsPrimitiveComponent->SetCollisionResponseToChannel(ECollisionChannel::ECC_GameTraceChannel1, ECollisionResponse::ECR_Overlap);
 	}
-
+	MARK_PROPERTY_DIRTY_FROM_NAME(ASlotableActor, currentGripState, this);
 
 	reset_GrippingParameters();
 }
 
 void ASlotableActor::manualFindAvailableSlotsCall()
 {
-	currentlyAvailable_Slots.Empty();
-	TArray<UPrimitiveComponent*> overlappingComponents;
-	ColliderComponent->GetOverlappingComponents(overlappingComponents);
+	ITEMSLOTS_SCOPE(ManualFind);
+	currentlyAvailable_Slots.Reset();
 
-	int nrOfOverlaps = overlappingComponents.Num();
-	if (nrOfOverlaps > 0)
+	// Read the overlaps in place, GetOverlappingComponents would copy them into a new array.
+	for (const FOverlapInfo& overlap : ColliderComponent->GetOverlapInfos())
 	{
-		for (int i = 0; i < nrOfOverlaps; i++)
+		const UPrimitiveComponent* overlappingComponent = overlap.OverlapInfo.GetComponent();
+		UItemSlot* slot = overlappingComponent ? Cast<UItemSlot>(overlappingComponent->GetAttachParent()) : nullptr;
+		if (slot)
 		{
-			UItemSlot* slot = Cast<UItemSlot>(overlappingComponents[i]->GetAttachParent());
-			if (slot)
+			if (currentGripState == EItemGripState::gripped)
 			{
-				if (currentGripState == EItemGripState::gripped)
-				{
-					if (slot->CheckForCompatibility(this))
-						if (slot->SlotState() == EItemSlotState::available)
-							addSlotToList(slot, true);
-						else
-							subscribeToSlotAvailableEvent(slot);
-				}
+				if (slot->CheckForCompatibility(this))
+					if (slot->SlotState() == EItemSlotState::available)
+						addSlotToList(slot, true);
+					else
+						subscribeToSlotAvailableEvent(slot);
 			}
 		}
-		if (HasAuthority())
-			refreshNearestSlot();
+	}
+
+	if (HasAuthority())
+	{
+		refreshRegistrySlots();
+		refreshNearestSlot();
 	}
 }
-void ASlotableActor::refreshNearestSlot_Implementation()
+
+void ASlotableActor::refreshRegistrySlots()
 {
-	UItemSlot* newNearest = findNearestSlot(currentlyAvailable_Slots);
-	if (newNearest != currentNearestSlot)
+	UItemSlotSubsystem* registry = UItemSlotSubsystem::Get(this);
+	if (!registry || !ColliderComponent) { return; }
+
+	ITEMSLOTS_SCOPE(RegistryRefresh);
+
+	FItemSlotCandidates& nearAvailable = nearAvailableScratch;
+	FItemSlotCandidates& nearUnavailable = nearUnavailableScratch;
+	nearAvailable.Reset();
+	nearUnavailable.Reset();
+	registry->FindCompatibleSlotsNear(ColliderComponent->GetComponentLocation(), ColliderComponent->GetScaledSphereRadius(), this, nearAvailable, &nearUnavailable);
+
+	// Registry-only slots never raise overlap end events, leaving their range is detected here instead.
+	for (int32 i = currentlyAvailable_Slots.Num() - 1; i >= 0; i--)
 	{
+		UItemSlot* slot = currentlyAvailable_Slots[i];
+		if (slot && slot->UsesSpatialRegistryOnly() && !nearAvailable.Contains(slot))
+			removeSlotFromList(slot);
+	}
+	for (int32 i = availableSubscriptions.Num() - 1; i >= 0; i--)
+	{
+		UItemSlot* slot = availableSubscriptions[i].Slot.Get();
+		if (!slot)
+			availableSubscriptions.RemoveAtSwap(i);
+		else if (slot->UsesSpatialRegistryOnly() && !nearUnavailable.Contains(slot))
+			unsubscribeFromAvailableEvent(slot);
+	}
+
+	bool slotAdded = false;
+	for (UItemSlot* slot : nearAvailable)
+	{
+		if (!slot->UsesSpatialRegistryOnly() || currentlyAvailable_Slots.Contains(slot)) { continue; }
+		addSlotToList(slot, true);
+		slotAdded = true;
+	}
+	for (UItemSlot* slot : nearUnavailable)
+	{
+		if (slot->UsesSpatialRegistryOnly())
+			subscribeToSlotAvailableEvent(slot);
+	}
+
+	if (slotAdded)
+		refreshNearestSlot();
+}
+
+void ASlotableActor::refreshNearestSlot()
+{
+	applyNearestSlot(findNearestSlot(currentlyAvailable_Slots));
+}
+
+void ASlotableActor::applyNearestSlot(UItemSlot* newNearest, bool skipHold)
+{
+	ITEMSLOTS_SCOPE(ApplyNearest);
+
+	// The owning client's accepted prediction wins over the solver while it stays a candidate.
+	if (UItemSlot* clientPredicted = clientPredictedSlot.Get())
+	{
+		if (currentlyAvailable_Slots.Contains(clientPredicted) && clientPredicted->IsAvailableFor(this))
+			newNearest = clientPredicted;
+		else
+			clientPredictedSlot = nullptr;
+	}
+
+	// Another gripper may have reserved it earlier in the same solve.
+	if (newNearest != nullptr && !newNearest->IsAvailableFor(this))
+		newNearest = nullptr;
+
+	if (newNearest == currentNearestSlot)
+		heldBackSlot = nullptr;
+	else
+	{
+		UItemSlotSubsystem* registry = UItemSlotSubsystem::Get(this);
+		if (!skipHold && shouldHoldReservation(newNearest))
+		{
+			// Counted once per slot held back, not for every frame it stays held back.
+			if (registry && newNearest != heldBackSlot.Get())
+				registry->CountReservationSwitch(true);
+			heldBackSlot = newNearest;
+			return;
+		}
+
+		if (registry)
+			registry->CountReservationSwitch(false);
+		heldBackSlot = nullptr;
+		lastReservationSwitchTime = GetWorld()->GetTimeSeconds();
+
 		if (currentNearestSlot != nullptr)
 		{
-			unsubscribeFromOccupiedEvent(currentNearestSlot);
 			unsubscribeFromAvailableEvent(currentNearestSlot);
 
 			currentNearestSlot->ActorOutOfRangeEventInstigation(this);
@@ -152,39 +287,168 @@ void ASlotableActor::refreshNearestSlot_Implementation()
 
 		if (newNearest != nullptr)
 		{
-			UE_LOG(LogTemp, Warning, TEXT("%s: reserving"), *GetName());
+			UE_LOG(LogItemSlots, Verbose, TEXT("%s: reserving %s"), *GetName(), *newNearest->GetName());
 			newNearest->ReserveForActor_Server(this, handSide);
 		}
 		currentNearestSlot = newNearest;
+		MARK_PROPERTY_DIRTY_FROM_NAME(ASlotableActor, currentNearestSlot, this);
 	}
 }
-UItemSlot* ASlotableActor::findNearestSlot(TArray<UItemSlot*> slotsToCheck)
+
+void ASlotableActor::updatePredictedReservation()
 {
-	if (slotsToCheck.Num() > 0)
-		if (slotsToCheck.Num() > 1)
-		{
-			float nearestDist = std::numeric_limits<float>::max();	// max float value
-			int nearestSlotIndex = 0;
-			for (int i = 0; i < slotsToCheck.Num(); i++)
-			{
-				auto thisSlotPtr = slotsToCheck[i];
-				if (thisSlotPtr != nullptr)
-				{
-					float thisDistance = FVector::DistSquared(this->GetActorLocation(), thisSlotPtr->GetComponentLocation());
-					if (thisDistance < nearestDist)
-					{
-						nearestDist = thisDistance;
-						nearestSlotIndex = i;
-					}
-				}
-			}
-			return slotsToCheck[nearestSlotIndex];
-		}
-		else
+	UItemSlotSubsystem* registry = UItemSlotSubsystem::Get(this);
+	if (!registry || !ColliderComponent || currentGripState != EItemGripState::gripped) { return; }
+
+	// Slot states here are the replicated ones, so this is the server's view as of the last update.
+	FItemSlotCandidates& nearAvailable = nearAvailableScratch;
+	nearAvailable.Reset();
+	registry->FindCompatibleSlotsNear(ColliderComponent->GetComponentLocation(), ColliderComponent->GetScaledSphereRadius(), this, nearAvailable);
+
+	if (UItemSlot* rejected = rejectedPredictionSlot.Get())
+	{
+		if (nearAvailable.RemoveSingleSwap(rejected) == 0)
+			rejectedPredictionSlot = nullptr;
+	}
+
+	UItemSlot* previous = predictedSlot.Get();
+	UItemSlot* nearest = findNearestSlot(nearAvailable);
+	if (nearest == previous) { return; }
+
+	// Same distance hysteresis as the server, so both sides tend to settle on the same slot.
+	if (nearest && previous && nearAvailable.Contains(previous))
+	{
+		const float predictedDistance = FVector::Dist(GetActorLocation(), previous->GetComponentLocation());
+		const float nearestDistance = FVector::Dist(GetActorLocation(), nearest->GetComponentLocation());
+		if (nearestDistance + UItemSlotSettings::Get()->ReservationHysteresisDistance > predictedDistance) { return; }
+	}
+
+	if (previous)
+		previous->ClearPredictedReservation(this);
+
+	predictedSlot = nearest;
+	if (!nearest) { return; }
+
+	nearest->SetPredictedReservation(this, handSide);
+	predictionId++;
+	Server_PredictReservation(nearest, predictionId);
+}
+
+void ASlotableActor::clearPredictedReservation()
+{
+	if (UItemSlot* previous = predictedSlot.Get())
+		previous->ClearPredictedReservation(this);
+
+	predictedSlot = nullptr;
+	rejectedPredictionSlot = nullptr;
+}
+
+void ASlotableActor::Server_PredictReservation_Implementation(UItemSlot* slot, uint16 clientPredictionId)
+{
+	// The client only sees replicated state. Its choice counts if the slot is a candidate here too, the hold was already applied on its side.
+	if (currentGripState == EItemGripState::gripped && slot && currentlyAvailable_Slots.Contains(slot) && slot->IsAvailableFor(this))
+	{
+		clientPredictedSlot = slot;
+		applyNearestSlot(slot, true);
+	}
+
+	Client_AckReservation(clientPredictionId, currentNearestSlot);
+}
+
+void ASlotableActor::Client_AckReservation_Implementation(uint16 clientPredictionId, UItemSlot* reservedSlot)
+{
+	// Superseded by a newer prediction, which gets its own answer. Not counted, see UItemSlotSubsystem::CountPredictionResult.
+	UItemSlot* predicted = predictedSlot.Get();
+	if (clientPredictionId != predictionId || !predicted) { return; }
+
+	const bool confirmed = reservedSlot == predicted;
+	if (UItemSlotSubsystem* registry = UItemSlotSubsystem::Get(this))
+		registry->CountPredictionResult(confirmed);
+
+	if (confirmed) { return; }
+
+	UE_LOG(LogItemSlots, Verbose, TEXT("%s: predicted %s, server reserved %s"), *GetName(), *predicted->GetName(), *GetNameSafe(reservedSlot));
+	predicted->ClearPredictedReservation(this);
+	rejectedPredictionSlot = predicted;
+	predictedSlot = nullptr;
+}
+
+void ASlotableActor::setResidingSlot(UItemSlot* slot)
+{
+	currentGripState = EItemGripState::slotted;
+	current_ResidingSlot = slot;
+	MARK_PROPERTY_DIRTY_FROM_NAME(ASlotableActor, currentGripState, this);
+	MARK_PROPERTY_DIRTY_FROM_NAME(ASlotableActor, current_ResidingSlot, this);
+}
+
+void ASlotableActor::setPooled(bool pooled)
+{
+	if (pooled)
+	{
+		DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+		currentGripState = EItemGripState::loose;
+		current_ResidingSlot = nullptr;
+		MARK_PROPERTY_DIRTY_FROM_NAME(ASlotableActor, currentGripState, this);
+		MARK_PROPERTY_DIRTY_FROM_NAME(ASlotableActor, current_ResidingSlot, this);
+		reset_GrippingParameters();
+	}
+
+	bPooled = pooled;
+	SetActorHiddenInGame(pooled);
+	SetActorEnableCollision(!pooled);
+	SetActorTickEnabled(!pooled);
+
+	// A dormant channel stays open and keeps the client's copy alive. Awake and irrelevant, the channel times out and
+	// clients destroy their copy. IsNetRelevantFor covers the default driver, the replication graph and Iris filter skip it.
+	if (UNetDriver* netDriver = GetNetDriver())
+	{
+		if (UItemSlotReplicationGraph* graph = Cast<UItemSlotReplicationGraph>(netDriver->GetReplicationDriver()))
+			graph->SetActorPooled(this, pooled);
+	}
+	SetNetDormancy(pooled ? DORM_Awake : GetClass()->GetDefaultObject<AActor>()->NetDormancy);
+	ForceNetUpdate();
+}
+
+bool ASlotableActor::IsNetRelevantFor(const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation) const
+{
+	if (bPooled) { return false; }
+
+	return Super::IsNetRelevantFor(RealViewer, ViewTarget, SrcLocation);
+}
+
+bool ASlotableActor::shouldHoldReservation(const UItemSlot* newNearest) const
+{
+	// Losing the reserved slot, or having nothing left to reserve, is never held back.
+	if (currentNearestSlot == nullptr || newNearest == nullptr) { return false; }
+	if (!currentlyAvailable_Slots.Contains(currentNearestSlot) || !currentNearestSlot->IsAvailableFor(this)) { return false; }
+
+	const UItemSlotSettings* settings = UItemSlotSettings::Get();
+	if (GetWorld()->GetTimeSeconds() - lastReservationSwitchTime < settings->MinReservationDwellTime)
+		return true;
+
+	const float currentDistance = FVector::Dist(GetActorLocation(), currentNearestSlot->GetComponentLocation());
+	const float newDistance = FVector::Dist(GetActorLocation(), newNearest->GetComponentLocation());
+	return newDistance + settings->ReservationHysteresisDistance > currentDistance;
+}
+
+UItemSlot* ASlotableActor::findNearestSlot(const FItemSlotCandidates& slotsToCheck) const
+{
+	ITEMSLOTS_SCOPE(FindNearest);
+	UItemSlot* nearestSlot = nullptr;
+	float nearestDist = std::numeric_limits<float>::max();	// max float value
+
+	for (UItemSlot* thisSlotPtr : slotsToCheck)
+	{
+		if (thisSlotPtr == nullptr || !thisSlotPtr->IsAvailableFor(this)) { continue; }
+
+		float thisDistance = FVector::DistSquared(this->GetActorLocation(), thisSlotPtr->GetComponentLocation());
+		if (thisDistance < nearestDist)
 		{
-			return slotsToCheck[0];
+			nearestDist = thisDistance;
+			nearestSlot = thisSlotPtr;
 		}
-	return nullptr;
+	}
+	return nearestSlot;
 }
 
 void ASlotableActor::setupColliderRef()
@@ -196,17 +460,21 @@ void ASlotableActor::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLi
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(ASlotableActor, currentGripState);
-	DOREPLIFETIME(ASlotableActor, currentGrippingController);
-	DOREPLIFETIME(ASlotableActor, handSide);
-	DOREPLIFETIME(ASlotableActor, current_ResidingSlot);
-	DOREPLIFETIME(ASlotableActor, currentNearestSlot);
+	FDoRepLifetimeParams params;
+	params.bIsPushBased = true;
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(ASlotableActor, currentGripState, params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ASlotableActor, currentGrippingController, params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ASlotableActor, handSide, params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ASlotableActor, current_ResidingSlot, params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ASlotableActor, currentNearestSlot, params);
 }
 
 void ASlotableActor::checkForSlotOnOverlapBegin(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
 	if (currentGripState != EItemGripState::gripped) { return; }
 
+	ITEMSLOTS_SCOPE(Overlap);
 	UItemSlot* overlappingSlot;
 	overlappingSlot = Cast<UItemSlot>(OtherComp->GetAttachParent());
 
@@ -228,6 +496,7 @@ void ASlotableActor::checkForSlotOnOverlapEnd(UPrimitiveComponent* OverlappedCom
 
 void ASlotableActor::checkForSlotOnOverlapEndServer_Implementation(UPrimitiveComponent* OtherComp)
 {
+	ITEMSLOTS_SCOPE(Overlap);
 	UItemSlot* overlappingSlot;
 	overlappingSlot = Cast<UItemSlot>(OtherComp->GetAttachParent());
 
@@ -244,14 +513,8 @@ void ASlotableActor::removeSlotFromList(UItemSlot* slotToRemove)
 {
 	if (slotToRemove != nullptr)
 	{
-		if (currentlyAvailable_Slots.Contains(slotToRemove))
-			currentlyAvailable_Slots.Remove(slotToRemove);
-
-		if (becomeAvailableSlots.Contains(slotToRemove))
-			unsubscribeFromAvailableEvent(slotToRemove);
-
-		if (becomeOccupiedSlots.Contains(slotToRemove))
-			unsubscribeFromOccupiedEvent(slotToRemove);
+		currentlyAvailable_Slots.RemoveSingleSwap(slotToRemove);
+		unsubscribeFromAvailableEvent(slotToRemove);
 
 		if (!HasAuthority()) { return; }
 		if (slotToRemove == currentNearestSlot)
@@ -276,60 +539,52 @@ void ASlotableActor::addSlotToList(UItemSlot* slotToAdd, bool skipNearestRefresh
 void ASlotableActor::reset_GrippingParameters()
 {
 	currentGrippingController = nullptr;
-	currentlyAvailable_Slots.Empty();
+	currentlyAvailable_Slots.Reset();
 	currentNearestSlot = nullptr;
+	clientPredictedSlot = nullptr;
+	MARK_PROPERTY_DIRTY_FROM_NAME(ASlotableActor, currentGrippingController, this);
+	MARK_PROPERTY_DIRTY_FROM_NAME(ASlotableActor, currentNearestSlot, this);
 
-	for (int32 Index = becomeAvailableSlots.Num() - 1; Index >= 0; --Index)
-	{
-		unsubscribeFromAvailableEvent(becomeAvailableSlots[Index]);
-	}
-	for (int32 Index = becomeOccupiedSlots.Num() - 1; Index >= 0; --Index)
-	{
-		unsubscribeFromOccupiedEvent(becomeOccupiedSlots[Index]);
-	}
+	unsubscribeFromAllSlots();
 }
 
-void ASlotableActor::subscribeToSlotOccupiedEvent(UItemSlot* slot)
+int32 ASlotableActor::findSubscription(const FSlotSubscriptions& subscriptions, const UItemSlot* slot)
 {
-	if (becomeOccupiedSlots.Contains(slot)) { return; }
-	becomeOccupiedSlots.Add(slot);
-
-	slot->OnOccupied.BindLambda([this](UItemSlot* pSlot)
-		{
-			this->removeSlotFromList(pSlot);
-			unsubscribeFromOccupiedEvent(pSlot);
-			subscribeToSlotAvailableEvent(pSlot);
-		}
-	);
+	return subscriptions.IndexOfByPredicate([slot](const FSlotSubscription& subscription) { return subscription.Slot.Get() == slot; });
 }
 
-void ASlotableActor::unsubscribeFromOccupiedEvent(UItemSlot* slot)
+void ASlotableActor::onSlotAvailable(UItemSlot* slot)
 {
-	if (!slot) { return; }
-	if (!becomeOccupiedSlots.Contains(slot)) { return; }
-	becomeOccupiedSlots.Remove(slot);
-
-	slot->OnOccupied.Unbind();
+	addSlotToList(slot);
+	unsubscribeFromAvailableEvent(slot);
 }
+
 void ASlotableActor::subscribeToSlotAvailableEvent(UItemSlot* slot)
 {
-	if (becomeAvailableSlots.Contains(slot)) { return; }
-	becomeAvailableSlots.Add(slot);
+	if (!slot || findSubscription(availableSubscriptions, slot) != INDEX_NONE) { return; }
 
-	slot->OnAvailable.BindLambda([this](UItemSlot* pSlot)
-		{
-			addSlotToList(pSlot);
-			unsubscribeFromAvailableEvent(pSlot);
-		}
-	);
+	availableSubscriptions.Add({ slot, slot->OnAvailable.AddUObject(this, &ASlotableActor::onSlotAvailable) });
 
-	UE_LOG(LogTemp, Warning, TEXT("%s: Subbed"), *GetName());
+	UE_LOG(LogItemSlots, VeryVerbose, TEXT("%s: subscribed to %s becoming available"), *GetName(), *slot->GetName());
 }
 void ASlotableActor::unsubscribeFromAvailableEvent(UItemSlot* slot)
 {
 	if (!slot) { return; }
-	if (!becomeAvailableSlots.Contains(slot)) { return; }
-	becomeAvailableSlots.Remove(slot);
-	slot->OnAvailable.Unbind();
-	UE_LOG(LogTemp, Warning, TEXT("%s: Unsubbed"), *GetName());
+	const int32 index = findSubscription(availableSubscriptions, slot);
+	if (index == INDEX_NONE) { return; }
+
+	// Only this actor's binding goes, other actors waiting on the same slot keep theirs.
+	slot->OnAvailable.Remove(availableSubscriptions[index].Handle);
+	availableSubscriptions.RemoveAtSwap(index);
+	UE_LOG(LogItemSlots, VeryVerbose, TEXT("%s: unsubscribed from %s becoming available"), *GetName(), *slot->GetName());
+}
+void ASlotableActor::unsubscribeFromAllSlots()
+{
+	// Slots destroyed since subscribing have taken their delegates with them, only live ones are unbound.
+	for (const FSlotSubscription& subscription : availableSubscriptions)
+	{
+		if (UItemSlot* slot = subscription.Slot.Get())
+			slot->OnAvailable.Remove(subscription.Handle);
+	}
+	availableSubscriptions.Reset();
 }
@@ -0,0 +1,45 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "ItemSlotBenchmark.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FItemSlotSteadyStateAllocationTest, "DVREE.ItemSlots.Allocations.SteadyStateGripSweep",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FItemSlotSteadyStateAllocationTest::RunTest(const FString& Parameters)
+{
+	// Benchmark density: every collider overlaps 12 to 16 slots. Grippers stay gripped, so slots keep being reserved and released.
+	FItemSlotBenchmarkConfig config;
+	config.SlotNr = 400;
+	config.GripperNr = 4;
+	config.FrameNr = 600;
+	config.bReleaseGrippers = false;
+
+	// The first lap of the sweep grows the slot containers to what the path needs, the second one goes over the same slots.
+	const int32 warmupNr = 300;
+
+	TArray<FItemSlotBenchmarkFrame> frames;
+	if (!TestTrue(TEXT("Benchmark world set up"), FItemSlotBenchmark::Run(config, frames))) { return false; }
+
+	uint64 allocations = 0;
+	int32 allocatingFrames = 0;
+	int32 dirtySlots = 0;
+	for (int32 frame = warmupNr; frame < frames.Num(); frame++)
+	{
+		allocations += frames[frame].Allocations;
+		allocatingFrames += frames[frame].Allocations > 0 ? 1 : 0;
+		dirtySlots += frames[frame].DirtySlots;
+	}
+
+	AddInfo(FString::Printf(TEXT("%d frames after warmup: %d slot state changes, %llu allocations in %d frames"),
+		frames.Num() - warmupNr, dirtySlots, allocations, allocatingFrames));
+
+	TestTrue(TEXT("Slots were reserved and released during the sweep"), dirtySlots > 0);
+	TestEqual(TEXT("Slot container allocations after warmup"), allocations, static_cast<uint64>(0));
+	return true;
+}
+
+#endif
@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "ItemSlotBenchmark.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FItemSlotBenchmarkTest, "DVREE.ItemSlots.Benchmark",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FItemSlotBenchmarkTest::RunTest(const FString& Parameters)
+{
+	FItemSlotBenchmarkConfig config;
+	config.SlotNr = 256;
+	config.GripperNr = 4;
+	config.FrameNr = 270;
+
+	TArray<FItemSlotBenchmarkFrame> frames;
+	if (!TestTrue(TEXT("Benchmark world set up"), FItemSlotBenchmark::Run(config, frames))) { return false; }
+
+	double slotMs = 0.0;
+	uint64 rpcs = 0;
+	int32 dirtySlots = 0;
+	int64 bytes = 0;
+	uint64 allocations = 0;
+	for (const FItemSlotBenchmarkFrame& frame : frames)
+	{
+		slotMs += frame.SlotMs;
+		rpcs += frame.Rpcs;
+		dirtySlots += frame.DirtySlots;
+		bytes += frame.Bytes;
+		allocations += frame.Allocations;
+	}
+
+	AddInfo(FString::Printf(TEXT("%d frames: %.4f ms in slot code, %.2f RPCs, %.1f replicated bytes, %.2f allocations per frame"),
+		frames.Num(), slotMs / frames.Num(), static_cast<double>(rpcs) / frames.Num(), static_cast<double>(bytes) / frames.Num(), static_cast<double>(allocations) / frames.Num()));
+
+	// Every gripper is released over a slot at least twice, so slots were reserved and filled.
+	TestTrue(TEXT("Slots were reserved through RPCs"), rpcs > 0);
+	TestTrue(TEXT("Slot states replicated"), dirtySlots > 0);
+	TestTrue(TEXT("Replicated states have a measured size"), bytes > 0);
+	return true;
+}
+
+#endif
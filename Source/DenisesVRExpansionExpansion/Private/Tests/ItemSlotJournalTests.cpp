@@ -0,0 +1,152 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "ItemSlotJournal.h"
+#include "ItemSlot.h"
+#include "ItemSlotStandaloneWorld.h"
+#include "HAL/PlatformTime.h"
+
+namespace ItemSlotJournalTests
+{
+	//	One slot per entry, each with its own actor, all in one world so the journal sees real object names.
+	struct FJournalTestObjects
+	{
+		FJournalTestObjects(UWorld* world, int32 number)
+		{
+			for (int32 i = 0; i < number; i++)
+			{
+				Slots.Add(NewObject<UItemSlot>(world->GetWorldSettings()));
+				Actors.Add(world->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity));
+			}
+		}
+
+		TArray<UItemSlot*> Slots;
+		TArray<AActor*> Actors;
+	};
+
+	FItemSlotNetState reservedBy(AActor* actor)
+	{
+		FItemSlotNetState state;
+		state.State = EItemSlotState::reserved;
+		state.Actor = actor;
+		return state;
+	}
+}
+
+//	Wall-clock budget, so it runs with the benchmarks rather than the product tests.
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FItemSlotJournalRecordCostTest, "DVREE.ItemSlots.Journal.RecordCost",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FItemSlotJournalRecordCostTest::RunTest(const FString& Parameters)
+{
+	using namespace ItemSlotJournalTests;
+
+	// Recording runs inside every slot state commit, it has to stay well below a microsecond.
+	const double budgetNs = 1000.0;
+	const int32 recordNr = 200000;
+
+	FItemSlotStandaloneWorld world(TEXT("ItemSlotJournalCost"));
+	FJournalTestObjects objects(world.World, 64);
+
+	FItemSlotJournal journal;
+	journal.SetCapacity(4096);
+
+	// Steady state: every name is in the table and the ring has wrapped, so each record also releases an old entry.
+	const FItemSlotNetState available;
+	for (int32 i = 0; i < 4096; i++)
+		journal.Record(objects.Slots[i % 64], available, reservedBy(objects.Actors[i % 64]), static_cast<uint8>(EItemSlotEvent::Reserve), 0.0, i);
+
+	const double start = FPlatformTime::Seconds();
+	for (int32 i = 0; i < recordNr; i++)
+	{
+		const int32 index = i % 64;
+		journal.Record(objects.Slots[index], available, reservedBy(objects.Actors[(index * 7) % 64]), static_cast<uint8>(EItemSlotEvent::Reserve), 0.0, i);
+	}
+	const double averageNs = (FPlatformTime::Seconds() - start) * 1e9 / recordNr;
+
+	AddInfo(FString::Printf(TEXT("%d records, %.1f ns per record (budget %.0f ns)"), recordNr, averageNs, budgetNs));
+
+	TestEqual(TEXT("Journal entries"), journal.Num(), 4096);
+	TestTrue(TEXT("Average record cost within budget"), averageNs < budgetNs);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FItemSlotJournalProxyFlagTest, "DVREE.ItemSlots.Journal.ProxyFlag",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FItemSlotJournalProxyFlagTest::RunTest(const FString& Parameters)
+{
+	using namespace ItemSlotJournalTests;
+
+	FItemSlotStandaloneWorld world(TEXT("ItemSlotJournalProxy"));
+	FJournalTestObjects objects(world.World, 1);
+
+	FItemSlotJournal journal;
+	journal.SetCapacity(4);
+
+	const FItemSlotNetState available;
+	FItemSlotNetState proxy;
+	proxy.State = EItemSlotState::occupied;
+	proxy.bProxy = true;
+
+	journal.Record(objects.Slots[0], available, proxy, static_cast<uint8>(EItemSlotEvent::InsertProxy), 0.0, 0);
+	journal.Record(objects.Slots[0], proxy, reservedBy(objects.Actors[0]), FItemSlotJournalEntry::DirectCommit, 0.0, 1);
+
+	TArray<FItemSlotJournalEntry> entries;
+	journal.GetEntries(entries);
+	if (!TestEqual(TEXT("Journal entries"), entries.Num(), 2)) { return false; }
+
+	TestTrue(TEXT("Proxy insert journaled as becoming a proxy"), !entries[0].bFromProxy && entries[0].bToProxy);
+	TestTrue(TEXT("Leaving the proxy state journaled"), entries[1].bFromProxy && !entries[1].bToProxy);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FItemSlotJournalNameEvictionTest, "DVREE.ItemSlots.Journal.NameTableEviction",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FItemSlotJournalNameEvictionTest::RunTest(const FString& Parameters)
+{
+	using namespace ItemSlotJournalTests;
+
+	const int32 capacity = 32;
+	const int32 objectNr = 1000;
+
+	FItemSlotStandaloneWorld world(TEXT("ItemSlotJournalEviction"));
+	FJournalTestObjects objects(world.World, objectNr);
+
+	FItemSlotJournal journal;
+	journal.SetCapacity(capacity);
+
+	// Every record brings in a slot and an actor the journal never saw.
+	const FItemSlotNetState available;
+	int32 maxObjects = 0;
+	for (int32 i = 0; i < objectNr; i++)
+	{
+		journal.Record(objects.Slots[i], available, reservedBy(objects.Actors[i]), static_cast<uint8>(EItemSlotEvent::Reserve), 0.0, i);
+		maxObjects = FMath::Max(maxObjects, journal.NumObjects());
+	}
+
+	AddInfo(FString::Printf(TEXT("%d records, at most %d names in the table"), objectNr, maxObjects));
+
+	TestTrue(TEXT("Name table bounded by the entries in the ring"), maxObjects <= 2 * capacity);
+	TestEqual(TEXT("Names of the entries left in the ring"), journal.NumObjects(), 2 * capacity);
+
+	// Every entry left must still resolve to the names it was recorded with.
+	TArray<FItemSlotJournalEntry> entries;
+	journal.GetEntries(entries);
+	for (int32 i = 0; i < entries.Num(); i++)
+	{
+		const FItemSlotJournalObject* slotName = journal.FindObject(entries[i].SlotId);
+		const FItemSlotJournalObject* actorName = journal.FindObject(entries[i].ActorId);
+		const int32 recordIndex = objectNr - entries.Num() + i;
+
+		TestTrue(TEXT("Slot name resolves"), slotName && slotName->Path == objects.Slots[recordIndex]->GetPathName());
+		TestTrue(TEXT("Actor name resolves"), actorName && actorName->Path == objects.Actors[recordIndex]->GetPathName());
+	}
+	return true;
+}
+
+#endif
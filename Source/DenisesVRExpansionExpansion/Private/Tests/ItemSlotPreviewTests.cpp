@@ -0,0 +1,82 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "ItemSlot.h"
+#include "ItemSlotLayout.h"
+#include "ItemSlotSettings.h"
+#include "ItemSlotStandaloneWorld.h"
+#include "ItemSlotSubsystem.h"
+#include "SlotableActor.h"
+#include "Engine/StaticMesh.h"
+
+namespace ItemSlotPreviewTests
+{
+	UItemSlot* addSlot(AActor* owner, UItemSlotLayout* layout, const FVector& location)
+	{
+		UItemSlot* slot = NewObject<UItemSlot>(owner);
+		slot->acceptedActors.Add(ASlotableActor::StaticClass());
+		if (const FObjectProperty* property = FindFProperty<FObjectProperty>(UItemSlot::StaticClass(), TEXT("layout")))
+			property->SetObjectPropertyValue_InContainer(slot, layout);
+
+		slot->SetWorldLocation(location);
+		slot->RegisterComponent();
+		return slot;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FItemSlotGhostPreviewCountTest, "DVREE.ItemSlots.Previews.GhostInstanceCount",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FItemSlotGhostPreviewCountTest::RunTest(const FString& Parameters)
+{
+	UItemSlotSettings* settings = GetMutableDefault<UItemSlotSettings>();
+	const TSoftObjectPtr<UMaterialInterface> savedMaterial = settings->GhostPreviewMaterial;
+	const float savedRadius = settings->GhostPreviewRadius;
+	settings->GhostPreviewMaterial.Reset();
+	settings->GhostPreviewRadius = 500.0f;
+
+	{
+		FItemSlotStandaloneWorld testWorld(TEXT("ItemSlotGhostPreviewTest"));
+		UItemSlotSubsystem* registry = UItemSlotSubsystem::Get(testWorld.World);
+
+		UStaticMesh* mesh = NewObject<UStaticMesh>(GetTransientPackage());
+		UItemSlotLayout* layout = NewObject<UItemSlotLayout>(GetTransientPackage());
+		FSlotableActorVisuals visuals;
+		visuals.ID = TEXT("Ghost");
+		visuals.Mesh = mesh;
+		layout->SetVisuals(ASlotableActor::StaticClass(), visuals);
+
+		// Three slots within the ghost radius of the origin, one far outside it.
+		AActor* owner = testWorld.World->SpawnActor<AActor>();
+		UItemSlot* nearSlot = ItemSlotPreviewTests::addSlot(owner, layout, FVector(0.0f, 0.0f, 0.0f));
+		ItemSlotPreviewTests::addSlot(owner, layout, FVector(100.0f, 0.0f, 0.0f));
+		ItemSlotPreviewTests::addSlot(owner, layout, FVector(200.0f, 0.0f, 0.0f));
+		ItemSlotPreviewTests::addSlot(owner, layout, FVector(5000.0f, 0.0f, 0.0f));
+
+		ASlotableActor* gripped = testWorld.World->SpawnActor<ASlotableActor>(FVector::ZeroVector, FRotator::ZeroRotator);
+		ASlotableActor* other = testWorld.World->SpawnActor<ASlotableActor>(FVector(0.0f, 1000.0f, 0.0f), FRotator::ZeroRotator);
+		testWorld.Tick(0.016f);
+
+		registry->ShowGhostPreviews(gripped);
+		TestEqual(TEXT("Ghosts of the slots within the radius"), registry->NumGhostPreviews(gripped), 3);
+		TestEqual(TEXT("Visible instances after showing"), registry->NumPreviewInstances(mesh, nullptr), 3);
+
+		// A reservation for another actor takes the slot's ghost away on the next tick.
+		nearSlot->ReserveForActor_Server(other, EControllerHand::Left);
+		testWorld.Tick(0.016f);
+		TestEqual(TEXT("Ghosts after another actor reserved a slot"), registry->NumGhostPreviews(gripped), 2);
+		TestEqual(TEXT("Visible instances after the reservation"), registry->NumPreviewInstances(mesh, nullptr), 2);
+
+		registry->HideGhostPreviews(gripped);
+		TestEqual(TEXT("Visible instances after hiding"), registry->NumPreviewInstances(mesh, nullptr), 0);
+	}
+
+	settings->GhostPreviewMaterial = savedMaterial;
+	settings->GhostPreviewRadius = savedRadius;
+	return true;
+}
+
+#endif
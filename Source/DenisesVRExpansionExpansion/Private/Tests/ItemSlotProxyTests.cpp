@@ -0,0 +1,104 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "ItemSlot.h"
+#include "ItemSlotSettings.h"
+#include "ItemSlotStandaloneWorld.h"
+#include "ItemSlotSubsystem.h"
+#include "SlotableActor.h"
+#include "EngineUtils.h"
+
+namespace ItemSlotProxyTests
+{
+	//	Slot owner with one registry-only slot accepting any slotable actor.
+	UItemSlot* spawnSlot(UWorld* world, bool levelPlaced)
+	{
+		AActor* owner = world->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity);
+		owner->bNetStartup = levelPlaced;
+		USceneComponent* root = NewObject<USceneComponent>(owner, TEXT("Root"));
+		owner->SetRootComponent(root);
+		root->RegisterComponent();
+
+		UItemSlot* slot = NewObject<UItemSlot>(owner, TEXT("Slot"));
+		slot->acceptedActors.Add(ASlotableActor::StaticClass());
+		slot->SetUseSpatialRegistryOnly(true);
+		slot->SetupAttachment(root);
+		owner->AddInstanceComponent(slot);
+		slot->RegisterComponent();
+		return slot;
+	}
+
+	bool insertProxy(UItemSlotSubsystem* registry, UItemSlot* slot)
+	{
+		FItemSlotLoadoutEntry entry;
+		entry.Slot = slot;
+		entry.ActorClass = ASlotableActor::StaticClass();
+
+		TArray<EItemSlotLoadoutResult> results;
+		return registry->ApplyLoadout(MakeArrayView(&entry, 1), results) == 1 && slot->IsProxy();
+	}
+
+	int32 countSlotableActors(UWorld* world)
+	{
+		int32 actorNr = 0;
+		for (TActorIterator<ASlotableActor> it(world); it; ++it)
+			actorNr++;
+		return actorNr;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FItemSlotProxyLifetimeTest, "DVREE.ItemSlots.Proxies.Lifetime",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FItemSlotProxyLifetimeTest::RunTest(const FString& Parameters)
+{
+	using namespace ItemSlotProxyTests;
+
+	UItemSlotSettings* settings = GetMutableDefault<UItemSlotSettings>();
+	const bool proxiesWereEnabled = settings->bProxySlottedItems;
+	settings->bProxySlottedItems = true;
+
+	{
+		FItemSlotStandaloneWorld testWorld(TEXT("ItemSlotProxyTest"));
+		UWorld* world = testWorld.World;
+		UItemSlotSubsystem* registry = UItemSlotSubsystem::Get(world);
+
+		// A level placed slot streaming out and in again keeps its proxy.
+		UItemSlot* levelSlot = spawnSlot(world, true);
+		TestTrue(TEXT("Proxy inserted into the level placed slot"), insertProxy(registry, levelSlot));
+		registry->UnregisterSlot(levelSlot);
+		TestEqual(TEXT("Proxy slots after unregistering"), registry->NumProxySlots(), 0);
+		registry->RegisterSlot(levelSlot);
+		TestTrue(TEXT("Proxy restored when the slot registers again"), levelSlot->IsProxy());
+		TestEqual(TEXT("Proxy slots after registering again"), registry->NumProxySlots(), 1);
+
+		// A spawned owner going away leaves its occupant behind.
+		UItemSlot* spawnedSlot = spawnSlot(world, false);
+		TestTrue(TEXT("Proxy inserted into the spawned slot"), insertProxy(registry, spawnedSlot));
+		const int32 actorNr = countSlotableActors(world);
+		registry->UnregisterSlot(spawnedSlot);
+		TestEqual(TEXT("Occupant spawned from the record"), countSlotableActors(world), actorNr + 1);
+
+		// Pooled actors are out of every client's relevancy until they are handed out again.
+		ASlotableActor* actor = registry->AcquireProxyActor(ASlotableActor::StaticClass(), levelSlot);
+		if (TestNotNull(TEXT("Proxy actor"), actor))
+		{
+			AActor* viewer = levelSlot->GetOwner();
+			registry->ReleaseProxyActor(actor);
+			TestTrue(TEXT("Released actor is pooled"), actor->IsPooled());
+			TestFalse(TEXT("Pooled actor is not net relevant, not even to its former owner"), actor->IsNetRelevantFor(viewer, viewer, viewer->GetActorLocation()));
+			TestNotEqual(TEXT("Pooled actor isn't dormant"), static_cast<int32>(actor->NetDormancy), static_cast<int32>(DORM_DormantAll));
+
+			TestTrue(TEXT("Pooled actor handed out again"), registry->AcquireProxyActor(ASlotableActor::StaticClass(), levelSlot) == actor);
+			TestFalse(TEXT("Handed out actor is no longer pooled"), actor->IsPooled());
+		}
+	}
+
+	settings->bProxySlottedItems = proxiesWereEnabled;
+	return true;
+}
+
+#endif
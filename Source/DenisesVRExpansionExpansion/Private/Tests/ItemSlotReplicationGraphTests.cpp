@@ -0,0 +1,154 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "ItemSlot.h"
+#include "ItemSlotReplicationGraph.h"
+#include "ItemSlotReplicationMeasure.h"
+#include "ItemSlotSettings.h"
+#include "ItemSlotStandaloneWorld.h"
+#include "SlotableActor.h"
+
+namespace ItemSlotReplicationGraphTests
+{
+	//	Slot owner with its root at actorLocation and one slot at slotLocation.
+	AActor* spawnSlotOwner(UWorld* world, const FVector& actorLocation, const FVector& slotLocation)
+	{
+		AActor* owner = world->SpawnActor<AActor>(AActor::StaticClass(), FTransform(actorLocation));
+		USceneComponent* root = NewObject<USceneComponent>(owner, TEXT("Root"));
+		owner->SetRootComponent(root);
+		root->RegisterComponent();
+		root->SetWorldLocation(actorLocation);
+
+		UItemSlot* slot = NewObject<UItemSlot>(owner, TEXT("Slot"));
+		slot->SetUseSpatialRegistryOnly(true);
+		slot->SetupAttachment(root);
+		owner->AddInstanceComponent(slot);
+		slot->RegisterComponent();
+		slot->SetWorldLocation(slotLocation);
+		return owner;
+	}
+
+	//	One gather of a connection with a single viewer.
+	struct FGather
+	{
+		TArray<UReplicationGraphNode_ItemSlots::FGatheredOwner> Owners;
+		UReplicationGraphNode_ItemSlots::FConnectionStats Stats;
+
+		//	Replication period the connection gave the actor, 0 if it didn't gather it.
+		int32 PeriodOf(const AActor* actor) const
+		{
+			const UReplicationGraphNode_ItemSlots::FGatheredOwner* owner = Owners.FindByPredicate(
+				[actor](const UReplicationGraphNode_ItemSlots::FGatheredOwner& gathered) { return gathered.Actor == actor; });
+			return owner ? owner->ReplicationPeriod : 0;
+		}
+		bool Contains(const AActor* actor) const { return PeriodOf(actor) > 0; }
+
+		/**
+		* Bits per net frame the connection's gathered actors take when each of them sends its full state once per period:
+		* the actor's replicated properties and those of its slots, measured the way the net driver would serialize them.
+		* Without periods it is what the connection would take unthrottled.
+		*/
+		double BitsPerFrame(bool withPeriods = true) const
+		{
+			double bits = 0.0;
+			for (const UReplicationGraphNode_ItemSlots::FGatheredOwner& owner : Owners)
+			{
+				const int64 ownerBits = FItemSlotReplicationMeasure::MeasureObjectBits(owner.Actor) + FItemSlotReplicationMeasure::MeasureSlotOwnerBits(owner.Actor);
+				bits += withPeriods ? static_cast<double>(ownerBits) / owner.ReplicationPeriod : ownerBits;
+			}
+			return bits;
+		}
+	};
+
+	FGather gather(const UReplicationGraphNode_ItemSlots* node, const FVector& view, const FVector& hand)
+	{
+		FGather result;
+		node->GatherOwners(MakeArrayView(&view, 1), MakeArrayView(&hand, 1), result.Owners, result.Stats);
+		return result;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FItemSlotRepGraphConnectionsTest, "DVREE.ItemSlots.Replication.RepGraphConnections",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FItemSlotRepGraphConnectionsTest::RunTest(const FString& Parameters)
+{
+	using namespace ItemSlotReplicationGraphTests;
+
+	const float radius = UItemSlotSettings::Get()->SlotRelevancyRadius;
+	const int32 throttledPeriod = UItemSlotSettings::Get()->ThrottledSlotReplicationPeriod;
+	if (!TestTrue(TEXT("Relevancy radius set"), radius > 0.0f)) { return false; }
+
+	FItemSlotStandaloneWorld testWorld(TEXT("ItemSlotRepGraphTest"), false);
+	UWorld* world = testWorld.World;
+
+	// Two connections on a line, their relevancy spheres overlap around the middle.
+	const FVector viewA(0.0f, 0.0f, 0.0f);
+	const FVector viewB(1.6f * radius, 0.0f, 0.0f);
+
+	AActor* ownerA = spawnSlotOwner(world, FVector(-0.5f * radius, 0.0f, 0.0f), FVector(-0.5f * radius, 0.0f, 0.0f));
+	AActor* ownerB = spawnSlotOwner(world, FVector(2.1f * radius, 0.0f, 0.0f), FVector(2.1f * radius, 0.0f, 0.0f));
+	AActor* shared = spawnSlotOwner(world, FVector(0.8f * radius, 0.0f, 0.0f), FVector(0.8f * radius, 0.0f, 0.0f));
+	AActor* farAway = spawnSlotOwner(world, FVector(10.0f * radius, 0.0f, 0.0f), FVector(10.0f * radius, 0.0f, 0.0f));
+	// Actor origin out of everyone's reach, its slot right next to A.
+	AActor* offsetSlot = spawnSlotOwner(world, FVector(-10.0f * radius, 0.0f, 0.0f), FVector(0.2f * radius, 0.0f, 0.0f));
+	ASlotableActor* item = world->SpawnActor<ASlotableActor>(ASlotableActor::StaticClass(), FTransform(FVector(1.9f * radius, 0.0f, 0.0f)));
+
+	UReplicationGraphNode_ItemSlots* node = NewObject<UReplicationGraphNode_ItemSlots>();
+	for (AActor* actor : TArray<AActor*>{ ownerA, ownerB, shared, farAway, offsetSlot, item })
+	{
+		TestTrue(FString::Printf(TEXT("%s is handled by the node"), *actor->GetName()), UReplicationGraphNode_ItemSlots::HandlesActor(actor));
+		node->NotifyAddNetworkActor(FNewReplicatedActorInfo(actor));
+	}
+	TestEqual(TEXT("Actors in the node"), node->NumSlotOwners(), 6);
+
+	// A's hand is at its own owner, B's hand away from everything.
+	const FGather gatherA = gather(node, viewA, ownerA->GetActorLocation());
+	const FGather gatherB = gather(node, viewB, viewB + FVector(0.0f, 0.0f, 5.0f * radius));
+
+	AddInfo(FString::Printf(TEXT("Connection A: %d cells, %d actors, %d throttled. Connection B: %d cells, %d actors, %d throttled"),
+		gatherA.Stats.GatheredCells, gatherA.Stats.GatheredOwners, gatherA.Stats.ThrottledOwners,
+		gatherB.Stats.GatheredCells, gatherB.Stats.GatheredOwners, gatherB.Stats.ThrottledOwners));
+
+	TestTrue(TEXT("A gathers its owner"), gatherA.Contains(ownerA));
+	TestFalse(TEXT("A doesn't gather B's owner"), gatherA.Contains(ownerB));
+	TestTrue(TEXT("B gathers its owner"), gatherB.Contains(ownerB));
+	TestFalse(TEXT("B doesn't gather A's owner"), gatherB.Contains(ownerA));
+
+	TestTrue(TEXT("A gathers the shared owner"), gatherA.Contains(shared));
+	TestTrue(TEXT("B gathers the shared owner"), gatherB.Contains(shared));
+	TestFalse(TEXT("Nobody gathers the far owner"), gatherA.Contains(farAway) || gatherB.Contains(farAway));
+
+	TestTrue(TEXT("Relevancy follows the slot center, not the actor origin"), gatherA.Contains(offsetSlot) && !gatherB.Contains(offsetSlot));
+	TestTrue(TEXT("Slotable actors are gathered like slot owners"), gatherB.Contains(item) && !gatherA.Contains(item));
+
+	TestEqual(TEXT("A's owner replicates at full rate for A"), gatherA.PeriodOf(ownerA), 1);
+	TestEqual(TEXT("The shared owner is throttled for A"), gatherA.PeriodOf(shared), throttledPeriod);
+	TestEqual(TEXT("The shared owner is throttled for B"), gatherB.PeriodOf(shared), throttledPeriod);
+	TestFalse(TEXT("Nothing is near B's hand"), gatherB.Owners.ContainsByPredicate(
+		[](const UReplicationGraphNode_ItemSlots::FGatheredOwner& gathered) { return gathered.ReplicationPeriod == 1; }));
+
+	// Per connection bandwidth of the gathered full states, with the periods the node handed out and without.
+	const double bitsA = gatherA.BitsPerFrame();
+	const double bitsB = gatherB.BitsPerFrame();
+	const double unthrottledBitsB = gatherB.BitsPerFrame(false);
+	AddInfo(FString::Printf(TEXT("Connection A: %.1f bytes per net frame (%.1f unthrottled). Connection B: %.1f bytes per net frame (%.1f unthrottled)"),
+		bitsA / 8.0, gatherA.BitsPerFrame(false) / 8.0, bitsB / 8.0, unthrottledBitsB / 8.0));
+
+	TestTrue(TEXT("Connections gather something to send"), bitsA > 0.0 && bitsB > 0.0);
+	if (throttledPeriod > 1)
+		TestTrue(TEXT("Throttling lowers B's bandwidth by its period"), FMath::IsNearlyEqual(bitsB * throttledPeriod, unthrottledBitsB, 1.0));
+
+	// Removal goes by what the node holds, not by re-checking the actor.
+	TestTrue(TEXT("Removing a held actor"), node->NotifyRemoveNetworkActor(FNewReplicatedActorInfo(shared)));
+	TestFalse(TEXT("Removing it twice"), node->NotifyRemoveNetworkActor(FNewReplicatedActorInfo(shared), false));
+	TestFalse(TEXT("Removed actor is gone"), node->ContainsActor(shared));
+	TestTrue(TEXT("Swapped actor is still found"), node->ContainsActor(item));
+	TestFalse(TEXT("A no longer gathers the removed owner"), gather(node, viewA, viewA).Contains(shared));
+	return true;
+}
+
+#endif
@@ -0,0 +1,118 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "ItemSlot.h"
+#include "ItemSlotReplicationMeasure.h"
+#include "ItemSlotStandaloneWorld.h"
+#include "SlotableActor.h"
+#include "UObject/CoreNet.h"
+
+namespace ItemSlotReplicationTests
+{
+	//	Authoring data the way levels fill it in, set through reflection since it isn't public.
+	void setVisualsId(UItemSlot* slot, const TCHAR* propertyName, const TCHAR* id)
+	{
+		if (const FStructProperty* property = FindFProperty<FStructProperty>(UItemSlot::StaticClass(), propertyName))
+			property->ContainerPtrToValuePtr<FSlotableActorVisuals>(slot)->ID = id;
+	}
+
+	//	Writes the state and reads it back, without a package map: the state must not hold an actor.
+	int64 roundTrip(FItemSlotNetState& state, FItemSlotNetState& outReceived)
+	{
+		FNetBitWriter writer(nullptr, 64);
+		bool success = true;
+		state.NetSerialize(writer, nullptr, success);
+
+		FNetBitReader reader(nullptr, writer.GetData(), writer.GetNumBits());
+		outReceived.NetSerialize(reader, nullptr, success);
+		return success ? writer.GetNumBits() : -1;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FItemSlotInitialReplicationSizeTest, "DVREE.ItemSlots.Replication.InitialSlotOwnerSize",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FItemSlotInitialReplicationSizeTest::RunTest(const FString& Parameters)
+{
+	FItemSlotStandaloneWorld testWorld(TEXT("ItemSlotReplicationTest"), false);
+
+	// A holster actor with four slots.
+	AActor* owner = testWorld.World->SpawnActor<AActor>();
+	for (int32 i = 0; i < 4; i++)
+	{
+		UItemSlot* slot = NewObject<UItemSlot>(owner);
+		slot->acceptedActors.Add(ASlotableActor::StaticClass());
+		ItemSlotReplicationTests::setVisualsId(slot, TEXT("triggerVisuals"), TEXT("Trigger"));
+		ItemSlotReplicationTests::setVisualsId(slot, TEXT("currentlyDisplayedVisuals"), TEXT("BP_SlotableActor_C"));
+	}
+
+	int32 slotNr = 0;
+	const int64 afterBits = FItemSlotReplicationMeasure::MeasureSlotOwnerBits(owner, &slotNr);
+
+	int64 beforeBits = 0;
+	TInlineComponentArray<UItemSlot*> slots(owner);
+	for (const UItemSlot* slot : slots)
+		beforeBits += FItemSlotReplicationMeasure::MeasureLegacySlotBits(slot);
+
+	AddInfo(FString::Printf(TEXT("Initial replication of %d slots: %lld bytes before the data split, %lld bytes after"), slotNr, (beforeBits + 7) / 8, (afterBits + 7) / 8));
+
+	TestEqual(TEXT("Slots on the owner"), slotNr, 4);
+	TestTrue(TEXT("Initial replication is smaller than before the data split"), afterBits < beforeBits);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FItemSlotNetStateSizeTest, "DVREE.ItemSlots.Replication.NetStateSize",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FItemSlotNetStateSizeTest::RunTest(const FString& Parameters)
+{
+	struct FCase
+	{
+		const TCHAR* Name;
+		FItemSlotNetState State;
+		int64 BitBudget;
+	};
+
+	FCase cases[3];
+	cases[0] = { TEXT("Available"), FItemSlotNetState(), 10 };
+
+	cases[1] = { TEXT("ProxyOccupied"), FItemSlotNetState(), 18 };
+	cases[1].State.State = EItemSlotState::occupied;
+	cases[1].State.ClassIndex = 3;
+	cases[1].State.bProxy = true;
+
+	cases[2] = { TEXT("ReservedLeftHand"), FItemSlotNetState(), 18 };
+	cases[2].State.State = EItemSlotState::reserved;
+	cases[2].State.HandSide = EControllerHand::Left;
+	cases[2].State.ClassIndex = 0;
+
+	for (FCase& testCase : cases)
+	{
+		FItemSlotNetState received;
+		received.State = EItemSlotState::occupied;
+		received.ClassIndex = 7;
+
+		const int64 bits = ItemSlotReplicationTests::roundTrip(testCase.State, received);
+		const int64 reflectedBits = FItemSlotReplicationMeasure::MeasureReflectedNetStateBits(testCase.State);
+
+		AddInfo(FString::Printf(TEXT("%s: %lld bits, %lld replicated property by property"), testCase.Name, bits, reflectedBits));
+
+		TestTrue(FString::Printf(TEXT("%s serialized"), testCase.Name), bits >= 0);
+		TestTrue(FString::Printf(TEXT("%s reads back to the sent state"), testCase.Name), received == testCase.State);
+		TestTrue(FString::Printf(TEXT("%s within its budget of %lld bits"), testCase.Name, testCase.BitBudget), bits <= testCase.BitBudget);
+		TestTrue(FString::Printf(TEXT("%s smaller than property by property"), testCase.Name), bits < reflectedBits);
+	}
+
+	// A state with an actor adds the NetGUID and nothing else.
+	FItemSlotStandaloneWorld testWorld(TEXT("ItemSlotNetStateSizeTest"), false);
+	FItemSlotNetState withActor = cases[2].State;
+	withActor.Actor = testWorld.World->SpawnActor<AActor>();
+	TestEqual(TEXT("Actor costs one NetGUID"), FItemSlotReplicationMeasure::MeasureNetStateBits(withActor),
+		FItemSlotReplicationMeasure::MeasureNetStateBits(cases[2].State) + FItemSlotReplicationMeasure::NetGUIDBits);
+	return true;
+}
+
+#endif
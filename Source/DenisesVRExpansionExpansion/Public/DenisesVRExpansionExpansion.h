@@ -12,4 +12,9 @@ public:
 	/** IModuleInterface implementation */
 	virtual void StartupModule() override;
 	virtual void ShutdownModule() override;
+
+private:
+	void registerComponentVisualizers();
+
+	FDelegateHandle postEngineInitHandle;
 };
@@ -12,13 +12,15 @@
 #include "Net/UnrealNetwork.h"
 #include "SlotableActorVisuals.h"
 #include "ItemSlotState.h"
+#include "ItemSlotStateMachine.h"
 #include "CollisionShape.h"
 #include "ItemSlot.generated.h"
 
 class ASlotableActor;
+class UItemSlotSubsystem;
 
-DECLARE_DELEGATE_OneParam(FOnOccupiedDelegate, UItemSlot*);
-DECLARE_DELEGATE_OneParam(FOnAvailableDelegate, UItemSlot*);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnOccupiedDelegate, UItemSlot*);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnAvailableDelegate, UItemSlot*);
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnActorReceivedEvent);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnActorExitEvent);
@@ -34,34 +36,48 @@ public:
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item Slot editing", meta = (DisplayPriority = "4"))
 	TMap<TSubclassOf<class ASlotableActor>, FSlotableActorVisuals> actorVisuals_Map;
 
-	UPROPERTY(Replicated, EditAnywhere, BlueprintReadWrite)	UStaticMesh* boxMesh;
-	UPROPERTY(Replicated, EditAnywhere, BlueprintReadWrite)	UStaticMesh* sphereMesh;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)					uint8 editorCollisionShape = 1;	//sphere
-	UPROPERTY(Replicated, EditAnywhere, BlueprintReadWrite)		FSlotableActorVisuals triggerVisuals;
-	UPROPERTY(Replicated, VisibleAnywhere, BlueprintReadWrite)	FSlotableActorVisuals rootVisuals;
-	UPROPERTY(Replicated, VisibleAnywhere, BlueprintReadWrite)	FSlotableActorVisuals currentlyDisplayedVisuals;
-	UPROPERTY(Replicated, VisibleAnywhere, BlueprintReadWrite)	TSubclassOf<class ASlotableActor> currentlyDisplayedSlotableActor;
-
-	UPROPERTY(Replicated)										TEnumAsByte<EItemSlotState> currentState = EItemSlotState::available;
-	UPROPERTY(Replicated)										AActor* reservedForActor;
-	UPROPERTY(Replicated)										USphereComponent* transformRoot;
-	UPROPERTY()	UStaticMeshComponent* visualsComponent;
+	//	Optional shared visuals. When set, it is used at runtime instead of actorVisuals_Map.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item Slot editing", meta = (DisplayPriority = "4"))
+	TObjectPtr<class UItemSlotLayout> layout;
+
+	//	Authoring data below is identical on every machine (it comes from the level / blueprint), so none of it replicates.
+	//	Only netState changes at runtime.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)	UStaticMesh* boxMesh;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)	UStaticMesh* sphereMesh;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)			uint8 editorCollisionShape = 1;	//sphere
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)			FSlotableActorVisuals triggerVisuals;
+	UPROPERTY(VisibleAnywhere, BlueprintReadWrite)		FSlotableActorVisuals rootVisuals;
+	UPROPERTY(VisibleAnywhere, BlueprintReadWrite)		FSlotableActorVisuals currentlyDisplayedVisuals;
+	UPROPERTY(VisibleAnywhere, BlueprintReadWrite)		TSubclassOf<class ASlotableActor> currentlyDisplayedSlotableActor;
+
+	UPROPERTY(ReplicatedUsing = OnRep_NetState)			FItemSlotNetState netState;
+	//	Set for the slots of a UItemSlotContainerComponent. Their netState replicates through the container's packed array instead.
+	TWeakObjectPtr<class UItemSlotContainerComponent> container;
+	int32 containerIndex = INDEX_NONE;
+	UPROPERTY(Transient)								USphereComponent* transformRoot;
+	//	Preview borrowed from the UItemSlotSubsystem pool while this slot shows a reservation, null otherwise.
+	UPROPERTY(Transient)	UStaticMeshComponent* visualsComponent;
 	UPROPERTY()	UShapeComponent* colliderComponent;
 
-	UPROPERTY(Replicated, EditAnywhere, BlueprintReadWrite, Category = "Item Slot editing", meta = (DisplayPriority = "2"))
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item Slot editing", meta = (DisplayPriority = "2"))
 	UMaterial* leftHandMaterial;
 
-	UPROPERTY(Replicated, EditAnywhere, BlueprintReadWrite, Category = "Item Slot editing", meta = (DisplayPriority = "3"))
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item Slot editing", meta = (DisplayPriority = "3"))
 	UMaterial* rightHandMaterial;
 
-	UPROPERTY(Replicated, EditAnywhere, BlueprintReadWrite, Category = "Item Slot editing", meta = (DisplayPriority = "4"))
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item Slot editing", meta = (DisplayPriority = "4"))
 	UMaterial* editorColliderMaterial;
 
+	//	When enabled, no trigger component is spawned for this slot. ASlotableActors find it through the UItemSlotSubsystem grid instead.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item Slot editing", meta = (DisplayPriority = "5"))
+	bool bUseSpatialRegistryOnly = false;
+
 public:
 	/**
 	* Editor-time function.
@@ -139,6 +155,15 @@ public:
 	void SaveRootTransform();
 	void SaveMeshTransform();
 	void SaveTriggerTransform();
+
+	const TMap<TSubclassOf<class ASlotableActor>, FSlotableActorVisuals>& E_GetInlineVisuals() const { return actorVisuals_Map; }
+
+	/**
+	* Editor-time function.
+	* Points this slot to the provided shared layout and drops the inline actorVisuals_Map.
+	* From then on the edit buttons and transform saves write to the layout.
+	*/
+	void E_UseLayout(class UItemSlotLayout* newLayout);
 #endif
 
 	UPROPERTY(BlueprintAssignable, Category = "ItemSlot")
@@ -152,16 +177,48 @@ public:
 
 	bool CheckForCompatibility(const ASlotableActor* actor);
 	void RemoveSlotableActor(ASlotableActor* actor);
-	const EItemSlotState SlotState() { return currentState; }
+	const EItemSlotState SlotState() const { return netState.State; }
+	const FItemSlotNetState& GetNetState() const { return netState; }
+
+	//	Occupied by a proxy instead of an actor, see UItemSlotSettings::bProxySlottedItems.
+	bool IsProxy() const { return netState.bProxy; }
+
+	//	True when the slot is available, or already reserved for the provided actor.
+	bool IsAvailableFor(const ASlotableActor* actor) const;
+
+	/**
+	* Client-side. Shows the reservation preview for the provided actor right away, before the server reserved the slot.
+	* The replicated state takes over as soon as it stops being available.
+	*/
+	void SetPredictedReservation(ASlotableActor* actor, const EControllerHand handSide);
+
+	//	Client-side. Drops the predicted reservation, if it is the provided actor's.
+	void ClearPredictedReservation(const ASlotableActor* actor);
+
+	//	World space bounds of this slot's trigger, whether or not a trigger component was spawned for it.
+	FBox GetTriggerBounds() const;
+	bool UsesSpatialRegistryOnly() const { return bUseSpatialRegistryOnly; }
+
+	//	False until the slot's setup ran. On the server that includes its trigger component, which may take a few frames after BeginPlay.
+	//	The subsystem doesn't pick a slot as nearest before it is ready.
+	bool IsReady() const { return bReady; }
+
+	//	Only has an effect before BeginPlay, for slots created at runtime.
+	void SetUseSpatialRegistryOnly(bool registryOnly) { bUseSpatialRegistryOnly = registryOnly; }
 
 
 	// Function that is called on the server when an actor exits this components's collision.
 	UFUNCTION(Server, Reliable)			void ActorOutOfRangeEventInstigation(ASlotableActor* actor);
 
-	//	Event an an ASlotableActor could subscribe to get notified when this slot became occupied.
+	/**
+	* Server-side. Broadcast when this slot stopped being available (reserved or occupied). Any number of actors can wait on it,
+	* keep the FDelegateHandle to unsubscribe. Transitions are queued by UItemSlotSubsystem and broadcast at the end of its tick,
+	* in the order they happened: a slot that is taken and released within one frame raises OnOccupied, then OnAvailable.
+	* Handlers see the slot's current state, which may already be past the transition they are called for.
+	*/
 	FOnOccupiedDelegate OnOccupied;
 
-	//	Event an an ASlotableActor could subscribe to get notified when this slot became available again.
+	//	Server-side. Broadcast when this slot became available again, batched like OnOccupied.
 	FOnAvailableDelegate OnAvailable;
 
 
@@ -169,42 +226,137 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item Slot editing", meta = (DisplayPriority = "1"))
 	TArray<TSubclassOf<class ASlotableActor>> acceptedActors;
 
+	//	When enabled, subclasses of the classes in acceptedActors are accepted as well.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item Slot editing", meta = (DisplayPriority = "1"))
+	bool bAcceptChildClasses = false;
+
 private:
+	friend class UItemSlotSubsystem;
+	friend class UItemSlotContainerComponent;
+	template<EItemSlotEvent Event> friend struct TItemSlotTransition;
+
+	//	Index of this slot in the UItemSlotSubsystem grid, INDEX_NONE while unregistered.
+	int32 registryIndex = INDEX_NONE;
+
+	//	colliderComponent is a pooled trigger, see UItemSlotSettings::bLazySlotTriggers.
+	bool bLazyTrigger = false;
+
+	bool bReady = false;
+
+	//	Trigger transform relative to this component, cached on BeginPlay.
+	FTransform triggerToSlotTransform;
+
+	//	One bit per UItemSlotSubsystem class ID, set when that ASlotableActor class is accepted by this slot.
+	TBitArray<> compatibilityBits;
+
+	//	Preview instance while this slot shows a reservation with EItemSlotPreviewRendering::Instanced.
+	FItemSlotPreviewInstance previewInstance;
+
+	//	Local actor that predicted a reservation of this slot, see SetPredictedReservation.
+	UPROPERTY(Transient) TObjectPtr<ASlotableActor> predictedFor = nullptr;
+	EControllerHand predictedHandSide = EControllerHand::AnyHand;
+
+	bool acceptsClass(const UClass* actorClass) const;
+	void rebuildCompatibilityBits(UItemSlotSubsystem* registry);
+	void updateCompatibilityBit(int32 classId, const UClass* actorClass);
+
+	//	Visuals of the provided class, or of its nearest accepted parent class when child classes are accepted.
+	const FSlotableActorVisuals* findVisualsFor(const UClass* actorClass) const;
+
+	void onSlotTransformUpdated(USceneComponent* updatedComponent, EUpdateTransformFlags updateTransformFlags, ETeleportType teleport);
+
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
-	//	Makes a new key entry in actorVisuals_Map
+	//	Makes a new key entry in actorVisuals_Map, or in the layout when one is set.
 	void addActorToVisualsMap(TSubclassOf<class ASlotableActor> newActor);
 
-	// Removes an entry from actorVisuals_Map.
+	// Removes an entry from actorVisuals_Map. Entries of a shared layout are left to the other slots using it.
 	void removeActorFromVisualsArray(TSubclassOf<class ASlotableActor> removeActor);
 
+#if WITH_EDITOR
+	//	Editable visuals of exactly the provided class: the layout's entry when a layout is set, otherwise the inline one.
+	FSlotableActorVisuals* editVisualsOf(const UClass* actorClass);
+#endif
+
 	/**
-	* Multicast method that sets up the required components.
+	* Server-side. Creates the trigger component and marks the slot ready. Queued by BeginPlay and run by UItemSlotSubsystem
+	* within UItemSlotSettings::SlotSetupBudgetMs per frame.
 	*/
-	UFUNCTION(NetMulticast, Reliable)	void setupMulti();
+	void finishSetup();
 
 	/**
 	 * triggerComponent only exists on the server and so the setup should only run on it.
 	 * Collision detection happens on the server only.
 	 */
-	UFUNCTION(Server, Reliable)
 	void setupTriggerComponent();
 
+	//	Server-side. Occupies the available slot with the actor directly, used by UItemSlotSubsystem::ApplyLoadout.
+	bool insertActor(ASlotableActor* actor);
+
+	//	Proxy mode, server only. What the proxy occupying this slot is rebuilt from, empty otherwise.
+	UPROPERTY(Transient) FItemSlotProxyRecord proxyRecord;
+
+	//	Server-side. Occupies the available slot with a proxy of the provided class, without any actor.
+	bool insertProxy(TSubclassOf<ASlotableActor> actorClass);
+
 	/**
-	 * visualsComponent needs to be set up locally in order to work.
-	 * It is not replicated.
-	 */
-	UFUNCTION(Client, Reliable)
-	void setupVisualsComponent();
+	* Server-side. Records the occupant in proxyRecord, replaces it by a proxy and hands the actor to the registry's pool.
+	* rehydrate does the opposite with an actor from the pool. Both return whether the slot changed.
+	*/
+	bool dehydrate(UItemSlotSubsystem* registry);
+	bool rehydrate(UItemSlotSubsystem* registry);
 
-	// Multicast function that is called by the server to notify clients.
-	UFUNCTION(NetMulticast, Reliable)	void ActorOutOfRangeEventMulti(ASlotableActor* actor);
+	/**
+	* Turns this slot into entry entryIndex of the provided container, before it is registered.
+	* Copies the entry's authoring data and strips everything a container slot doesn't use (mesh, collision, trigger, tick, replication).
+	*/
+	void initContainerSlot(const struct FItemSlotContainerEntry& entry, class UItemSlotContainerComponent& owningContainer, int32 entryIndex);
 
-	// Client function that is called by a multicast event to handle local components when an actor exits this components's collision
-	UFUNCTION(Client, Reliable)			void ActorOutOfRangeEvent(ASlotableActor* actor);
+	//	Places colliderComponent on the trigger transform and sets up its collision.
+	void placeTrigger();
 
-	UFUNCTION(NetMulticast, Reliable)	void SetClientVisualsOnReserve(ASlotableActor* actor, const EControllerHand handSide);
-	UFUNCTION(Client, Reliable)			void SetVisuals(const FSlotableActorVisuals visualProperties, const EControllerHand handSide);
-	UFUNCTION(NetMulticast, Reliable)	void SetVisualsOn_ActorReceive(ASlotableActor* actor);
-	UFUNCTION(Client, Reliable)			void ReceiveActor();
+	//	Lazy trigger mode. Takes a trigger from the subsystem's pool, or puts it back.
+	bool acquireLazyTrigger(UItemSlotSubsystem* registry);
+	void releaseLazyTrigger(UItemSlotSubsystem* registry);
+
+	/**
+	* Server-side. Runs the event's TItemSlotTransition: rejects it when the current state or the guard doesn't allow it,
+	* otherwise commits the new state once and runs the transition's hook. Returns whether the transition happened.
+	*/
+	template<EItemSlotEvent Event>
+	bool transition(ASlotableActor* actor, EControllerHand handSide = EControllerHand::AnyHand);
+
+	/**
+	* Server-side. Replaces the replicated state and applies its local side effects right away, clients follow through OnRep_NetState.
+	* Gameplay code goes through transition(), only the journal replay commits states directly.
+	* The event that caused the change is journaled with it, FItemSlotJournalEntry::DirectCommit for direct commits.
+	*/
+	void commitNetState(const FItemSlotNetState& newState, uint8 event);
+
+	//	Runs transition() for an event known at runtime only. Used by the journal replay.
+	bool replayEvent(EItemSlotEvent event, ASlotableActor* actor, EControllerHand handSide);
+
+	UFUNCTION()	void OnRep_NetState(const FItemSlotNetState& previousState);
+	void countRpc();
+
+	/**
+	* Rebuilds everything local (preview visuals, occupant placement) from netState. Safe to run repeatedly,
+	* so late joiners and relevancy changes end up in the same place as machines that saw every change.
+	*/
+	void applyNetState(const FItemSlotNetState& previousState);
+
+	//	Index in acceptedActors of the entry that accepts the provided class.
+	int32 acceptedIndexFor(const UClass* actorClass) const;
+	const FSlotableActorVisuals* findVisualsForNetState() const;
+
+	FTransform getVisualsWorldTransform(const FSlotableActorVisuals& visuals) const;
+	//	Shows the preview of the replicated reservation or proxy, or of a predicted reservation while the slot is still available, otherwise hides it.
+	void refreshPreview();
+	void showPreview(const FSlotableActorVisuals& visualProperties, const EControllerHand handSide);
+	void showInstancedPreview(const FSlotableActorVisuals& visualProperties, UStaticMesh* mesh, const EControllerHand handSide);
+	//	Draws the proxy occupying this slot with the mesh's own materials.
+	void showProxy(const FSlotableActorVisuals& visualProperties);
+	UMaterialInterface* handMaterial(const EControllerHand handSide) const;
+	void hidePreview();
+	void placeOccupant(ASlotableActor* actor);
 };
@@ -0,0 +1,69 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+/**
+ * Heap allocator policy of the slot code's own containers: the candidate lists and the solver's scratch buffers.
+ * Allocates exactly like FHeapAllocator and counts every time one of those containers reaches the heap, so the benchmark and
+ * the automation tests can tell whether slot code allocated during a frame, see FItemSlotAllocationScope.
+ */
+class FItemSlotHeapAllocator : public FHeapAllocator
+{
+public:
+	class ForAnyElementType : public FHeapAllocator::ForAnyElementType
+	{
+	public:
+		void ResizeAllocation(SizeType previousNumElements, SizeType numElements, SIZE_T numBytesPerElement)
+		{
+			countAllocation(numElements);
+			FHeapAllocator::ForAnyElementType::ResizeAllocation(previousNumElements, numElements, numBytesPerElement);
+		}
+
+		void ResizeAllocation(SizeType previousNumElements, SizeType numElements, SIZE_T numBytesPerElement, uint32 alignmentOfElement)
+		{
+			countAllocation(numElements);
+			FHeapAllocator::ForAnyElementType::ResizeAllocation(previousNumElements, numElements, numBytesPerElement, alignmentOfElement);
+		}
+
+	private:
+		//	Shrinking to nothing frees, it doesn't allocate.
+		static void countAllocation(SizeType numElements)
+		{
+			if (numElements > 0)
+				AllocationNr.fetch_add(1, std::memory_order_relaxed);
+		}
+	};
+
+	template<typename ElementType>
+	class ForElementType : public ForAnyElementType
+	{
+	public:
+		ElementType* GetAllocation() const { return (ElementType*)ForAnyElementType::GetAllocation(); }
+	};
+
+	//	Heap allocations made by containers using this policy since startup.
+	static uint64 NumAllocations() { return AllocationNr.load(std::memory_order_relaxed); }
+
+private:
+	static inline std::atomic<uint64> AllocationNr{ 0 };
+};
+
+template <>
+struct TAllocatorTraits<FItemSlotHeapAllocator> : TAllocatorTraits<FHeapAllocator>
+{
+};
+
+/**
+ * Counts the FItemSlotHeapAllocator allocations made between its construction and Num().
+ * Other threads don't use slot containers, so the count is the slot code's own.
+ */
+struct FItemSlotAllocationScope
+{
+	uint64 Num() const { return FItemSlotHeapAllocator::NumAllocations() - start; }
+
+private:
+	uint64 start = FItemSlotHeapAllocator::NumAllocations();
+};
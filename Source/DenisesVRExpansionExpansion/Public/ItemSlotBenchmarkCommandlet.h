@@ -0,0 +1,31 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ItemSlotBenchmarkCommandlet.generated.h"
+
+/**
+ * Runs FItemSlotBenchmark from the command line: a grid of registry-only UItemSlots and simulated grippers in a standalone
+ * world that is ticked as a whole every frame.
+ *
+ * Writes one CSV row per frame: the world tick time and the UItemSlotSubsystem tick time within it, slot server RPC calls,
+ * the slots whose replicated state changed with the measured size of those states, and the heap allocations of slot containers.
+ * Returns 1 when an averaged value (after the warmup frames) exceeds one of the provided thresholds.
+ * The DVREE.ItemSlots.Benchmark automation test runs a smaller configuration of the same benchmark,
+ * DVREE.ItemSlots.Allocations.SteadyStateGripSweep checks that a grip sweep doesn't allocate once warmed up.
+ *
+ * Usage: -run=ItemSlotBenchmark -nullrhi -unattended [-Slots=1000] [-Grippers=8] [-Frames=600] [-Warmup=60] [-CycleFrames=90]
+ *        [-Csv=<path>] [-MaxSlotMs=<ms>] [-MaxRpcsPerFrame=<n>] [-MaxBytesPerFrame=<n>] [-MaxAllocsPerFrame=<n>]
+ */
+UCLASS()
+class UItemSlotBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UItemSlotBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,127 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SceneComponent.h"
+#include "ItemSlotState.h"
+#include "ItemSlotContainerComponent.generated.h"
+
+class ASlotableActor;
+class UItemSlot;
+class UItemSlotLayout;
+class UMaterial;
+
+/**
+ * One slot of a UItemSlotContainerComponent. Plain authoring data, nothing of it exists as a component in the editor.
+ */
+USTRUCT(BlueprintType)
+struct FItemSlotContainerEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Slot")
+	FName Name;
+
+	//	Relative to the container.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Slot")
+	FTransform RelativeTransform;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Slot")
+	TArray<TSubclassOf<ASlotableActor>> AcceptedActors;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Slot")
+	bool bAcceptChildClasses = false;
+
+	//	Visuals of the accepted classes. The container's DefaultLayout is used when empty.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Slot")
+	TObjectPtr<UItemSlotLayout> Layout;
+
+	//	Radius of the slot's trigger sphere, in cm.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Slot", meta = (ClampMin = "1.0"))
+	float TriggerRadius = 10.0f;
+};
+
+/**
+ * Runtime state of one container entry. The container replicates all of them as one packed array.
+ */
+USTRUCT()
+struct FItemSlotContainerSlot
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FItemSlotNetState NetState;
+
+	//	Local slot logic of the entry, created on every machine.
+	UPROPERTY(NotReplicated)
+	TObjectPtr<UItemSlot> Slot;
+};
+
+/**
+ * Holds any number of item slots on one scene component, e.g. the pouches of a vest.
+ * The slots are authored as FItemSlotContainerEntry structs and drawn by FItemSlotContainerVisualizer in the editor.
+ *
+ * The runtime state of all entries lives in one packed FItemSlotContainerSlot array, which is the only thing that replicates.
+ * In InitializeComponent every entry also gets a stripped down UItemSlot with a stable name on server and clients,
+ * so slot references and RPCs resolve like for authored slots. Those slots don't replicate themselves and have
+ * no mesh, no collision, no trigger (they are found through the UItemSlotSubsystem grid) and no tick.
+ * Previews come from the subsystem's pool like for any other slot.
+ *
+ * The entries are not plain structs at runtime: a container of N entries still registers N UItemSlot components, which follow
+ * the container's transform and each take part in the grid on their own. The slot RPCs, ASlotableActor's slot references,
+ * the grid, the nearest slot solve, the state machine and the journal all address slots as UItemSlot, addressing them as
+ * (container, index) instead would mean changing all of those. What the container saves is the authored components,
+ * the triggers, the preview meshes and the per-slot replication.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class UItemSlotContainerComponent : public USceneComponent
+{
+	GENERATED_BODY()
+
+public:
+	UItemSlotContainerComponent();
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Slots")
+	TArray<FItemSlotContainerEntry> Entries;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Slots")
+	TObjectPtr<UItemSlotLayout> DefaultLayout;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Slots")
+	TObjectPtr<UMaterial> LeftHandMaterial;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Slots")
+	TObjectPtr<UMaterial> RightHandMaterial;
+
+	//	Runtime slots, in the order of Entries. Empty before InitializeComponent and in the editor.
+	int32 NumSlots() const { return slots.Num(); }
+	UItemSlot* GetSlot(int32 entryIndex) const { return slots.IsValidIndex(entryIndex) ? slots[entryIndex].Slot.Get() : nullptr; }
+	UItemSlot* FindSlot(FName entryName) const;
+
+	//	World transform of an entry, for slots that haven't been created yet (editor, visualizer).
+	FTransform GetEntryWorldTransform(int32 entryIndex) const;
+
+	/**
+	* Server-side. Spawns the class given for each entry name straight into that entry's slot, through UItemSlotSubsystem::ApplyLoadout.
+	@return Number of entries slotted.
+	*/
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Item Slots")
+	int32 ApplyLoadout(const TMap<FName, TSubclassOf<ASlotableActor>>& EntryClasses);
+
+protected:
+	virtual void InitializeComponent() override;
+	virtual void UninitializeComponent() override;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+private:
+	friend class UItemSlot;
+
+	UPROPERTY(Transient, ReplicatedUsing = OnRep_Slots) TArray<FItemSlotContainerSlot> slots;
+
+	UFUNCTION()
+	void OnRep_Slots();
+
+	//	Server-side. Called by the slot of entryIndex whenever it commits a new state.
+	void onSlotStateCommitted(int32 entryIndex, const FItemSlotNetState& state);
+};
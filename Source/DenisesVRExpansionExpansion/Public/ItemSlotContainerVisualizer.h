@@ -0,0 +1,16 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+#if WITH_EDITOR
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ComponentVisualizer.h"
+
+/**
+ * Draws the slots of a UItemSlotContainerComponent in the editor viewport: a sphere of the trigger radius and the slot's axes per entry.
+ */
+class FItemSlotContainerVisualizer : public FComponentVisualizer
+{
+public:
+	virtual void DrawVisualization(const UActorComponent* Component, const FSceneView* View, FPrimitiveDrawInterface* PDI) override;
+};
+#endif
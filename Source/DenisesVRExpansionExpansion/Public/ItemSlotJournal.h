@@ -0,0 +1,104 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+#include "ItemSlotState.h"
+
+class UItemSlot;
+
+/**
+ * One slot state transition. Slots and actors are referenced by journal IDs, see FItemSlotJournalObject. ID 0 means none.
+ */
+struct FItemSlotJournalEntry
+{
+	//	Event of a state committed directly instead of through a transition, see UItemSlotSubsystem::ReplayTransition.
+	static constexpr uint8 DirectCommit = 0xFF;
+
+	double Time = 0.0;
+	uint32 Frame = 0;
+	uint32 SlotId = 0;
+	//	Actor of the new state, or of the previous one when the slot became available. That is always the event's actor.
+	uint32 ActorId = 0;
+	uint8 FromState = EItemSlotState::available;
+	uint8 ToState = EItemSlotState::available;
+	uint8 HandSide = 0;
+	int8 ClassIndex = INDEX_NONE;
+	//	EItemSlotEvent that caused the transition, the input the replay feeds back in.
+	uint8 Event = DirectCommit;
+	//	FItemSlotNetState::bProxy before and after the transition.
+	bool bFromProxy = false;
+	bool bToProxy = false;
+
+	friend FArchive& operator<<(FArchive& ar, FItemSlotJournalEntry& entry)
+	{
+		ar << entry.Time << entry.Frame << entry.SlotId << entry.ActorId << entry.FromState << entry.ToState << entry.HandSide << entry.ClassIndex << entry.Event
+			<< entry.bFromProxy << entry.bToProxy;
+		return ar;
+	}
+};
+
+//	Name table entry of a slot or actor that appears in the journal.
+struct FItemSlotJournalObject
+{
+	FString Path;
+	FString ClassPath;
+
+	friend FArchive& operator<<(FArchive& ar, FItemSlotJournalObject& object)
+	{
+		ar << object.Path << object.ClassPath;
+		return ar;
+	}
+};
+
+/**
+ * Server-side ring buffer of slot state transitions. Recording a transition is a map lookup and a few stores,
+ * only the first transition of a slot or actor adds its name to the table. Names are reference counted by the entries
+ * in the ring and dropped with the last entry using them, so the table stays bounded by the capacity.
+ * Written with DVREE.Slots.DumpJournal and played back in a fresh world with -run=ItemSlotReplay.
+ */
+class FItemSlotJournal
+{
+public:
+	//	Drops everything recorded so far. A capacity of 0 disables recording.
+	void SetCapacity(int32 capacity);
+	bool IsEnabled() const { return entries.Num() > 0; }
+
+	void Record(const UItemSlot* slot, const FItemSlotNetState& from, const FItemSlotNetState& to, uint8 event, double time, uint32 frame);
+
+	//	Recorded transitions, oldest first.
+	void GetEntries(TArray<FItemSlotJournalEntry>& outEntries) const;
+	int32 Num() const { return entryNr; }
+
+	const FItemSlotJournalObject* FindObject(uint32 id) const { return objects.IsValidIndex(id - 1) ? &objects[id - 1] : nullptr; }
+
+	//	Names referenced by the recorded entries.
+	int32 NumObjects() const { return objects.Num() - freeObjectIds.Num(); }
+
+	bool SaveToFile(const FString& path) const;
+
+	/**
+	* Loads a dumped journal. The loaded journal holds exactly the dumped entries and doesn't record.
+	*/
+	bool LoadFromFile(const FString& path);
+
+	void Reset();
+
+private:
+	//	Adds a reference to the object's name, adding the name on first use.
+	uint32 acquireObjectId(const UObject* object);
+	//	Drops a reference, and the name with the last one. Its ID is reused.
+	void releaseObjectId(uint32 id);
+
+	TArray<FItemSlotJournalEntry> entries;
+	int32 head = 0;
+	int32 entryNr = 0;
+
+	//	Indexed by ID - 1. Freed entries stay in place with an empty path until their ID is reused.
+	TArray<FItemSlotJournalObject> objects;
+	TArray<int32> objectRefs;
+	TArray<FObjectKey> objectKeys;
+	TArray<uint32> freeObjectIds;
+	TMap<FObjectKey, uint32> objectIds;
+};
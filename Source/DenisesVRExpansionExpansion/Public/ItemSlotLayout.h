@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "SlotableActorVisuals.h"
+#include "ItemSlotLayout.generated.h"
+
+class ASlotableActor;
+
+USTRUCT(BlueprintType)
+struct FItemSlotLayoutEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Slot Layout")
+	TSubclassOf<ASlotableActor> ActorClass;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Slot Layout")
+	FSlotableActorVisuals Visuals;
+};
+
+/**
+ * Per-class slot visuals shared by every UItemSlot that references this asset, instead of each slot keeping its own actorVisuals_Map.
+ * Entries are kept sorted by class so lookups are a binary search over one contiguous array.
+ */
+UCLASS(BlueprintType)
+class UItemSlotLayout : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	virtual void PostLoad() override;
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+	const FSlotableActorVisuals* FindVisuals(const UClass* actorClass) const;
+
+	/**
+	* Adds or replaces the visuals of the provided class and keeps the entries sorted.
+	*/
+	void SetVisuals(TSubclassOf<ASlotableActor> actorClass, const FSlotableActorVisuals& visuals);
+
+#if WITH_EDITOR
+	/**
+	* Editor-time function.
+	* Visuals of exactly the provided class, for editing in place. Marks the asset modified. Every slot using this layout sees the edit.
+	*/
+	FSlotableActorVisuals* E_EditVisuals(const UClass* actorClass);
+#endif
+
+	const TArray<FItemSlotLayoutEntry>& GetEntries() const { return entries; }
+
+	//	Memory held by the entries, strings included.
+	SIZE_T GetEntriesAllocatedSize() const;
+
+private:
+	void sortEntries();
+
+	UPROPERTY(EditAnywhere, Category = "Item Slot Layout")
+	TArray<FItemSlotLayoutEntry> entries;
+};
@@ -0,0 +1,24 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ItemSlotLayoutCommandlet.generated.h"
+
+/**
+ * Finds UItemSlots with identical inline actorVisuals_Maps in levels and blueprints and reports the memory a shared UItemSlotLayout would save.
+ *
+ * Usage: -run=ItemSlotLayout [-Apply] [-MinInstances=2] [-OutputPath=/Game/ItemSlotLayouts] [-Packages=/Game/A+/Game/B]
+ * -Apply creates one layout asset per group of identical maps, points the slots to it and saves the touched packages.
+ */
+UCLASS()
+class UItemSlotLayoutCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UItemSlotLayoutCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
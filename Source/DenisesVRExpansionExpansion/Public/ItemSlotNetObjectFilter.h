@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Iris/ReplicationSystem/Filtering/NetObjectFilter.h"
+#include "ItemSlotNetObjectFilter.generated.h"
+
+/**
+ * Iris counterpart of UReplicationGraphNode_ItemSlots. Slot owners and slotable actors are bucketed in a grid keyed on the center
+ * of their slots, a connection is only allowed the ones within UItemSlotSettings::SlotRelevancyRadius of its views, found by
+ * visiting the cells in reach of each view. Iris filters only decide relevancy, the graph node's hand throttling has no equivalent here.
+ *
+ * Register it in DefaultEngine.ini, UItemSlotSubsystem assigns it to the actors on the server:
+ *	[/Script/IrisCore.NetObjectFilterDefinitions]
+ *	+NetObjectFilterDefinitions=(FilterName=ItemSlotOwners, ClassName=/Script/DenisesVRExpansionExpansion.ItemSlotNetObjectFilter)
+ */
+UCLASS()
+class UItemSlotNetObjectFilter : public UNetObjectFilter
+{
+	GENERATED_BODY()
+
+public:
+	static const FName FilterName;
+
+	/**
+	* Server-side. Routes the actor through the filter. Returns false while the actor has no replication handle yet,
+	* and also when there is nothing to do: no Iris replication system, or no filter registered under FilterName.
+	* outRetry tells the two apart.
+	*/
+	static bool AddActor(AActor* actor, bool& outRetry);
+
+	int32 NumActors() const { return owners.Num(); }
+
+protected:
+	virtual void OnInit(FNetObjectFilterInitParams& Params) override;
+	virtual bool AddObject(uint32 ObjectIndex, FNetObjectFilterAddObjectParams& Params) override;
+	virtual void RemoveObject(uint32 ObjectIndex, const FNetObjectFilteringInfo& Info) override;
+	virtual void PreFilter(FNetObjectPreFilteringParams& Params) override;
+	virtual void Filter(FNetObjectFilteringParams& Params) override;
+
+private:
+	struct FOwner
+	{
+		TWeakObjectPtr<AActor> Actor;
+		FIntVector Cell = FIntVector::ZeroValue;
+		FVector Center = FVector::ZeroVector;
+		bool bMovable = false;
+		//	Pooled proxy actor, never allowed so clients drop their copy.
+		bool bPooled = false;
+	};
+
+	FIntVector toCell(const FVector& location) const;
+	void removeFromCell(const FIntVector& cell, uint32 objectIndex);
+
+	//	Keyed by Iris internal object index. Entries are added by AddActor before the replication system calls AddObject.
+	TMap<uint32, FOwner> owners;
+	TMap<FIntVector, TArray<uint32>> cells;
+};
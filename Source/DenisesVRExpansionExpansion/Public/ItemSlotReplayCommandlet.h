@@ -0,0 +1,26 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ItemSlotReplayCommandlet.generated.h"
+
+/**
+ * Plays a slot transition journal (DVREE.Slots.DumpJournal) back in a fresh headless world.
+ * Spawns one registry-only slot per journaled slot and one actor per journaled actor, then feeds every journaled event back into
+ * its slot's state machine in order and checks that the slot ends up in the journaled state, with the journaled actor and proxy flag.
+ * A rejected event is a mismatch. Returns 1 on the first mismatch unless -ContinueOnMismatch is set.
+ *
+ * Usage: -run=ItemSlotReplay -nullrhi -unattended -Journal=<path> [-ContinueOnMismatch] [-LogTransitions]
+ */
+UCLASS()
+class UItemSlotReplayCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UItemSlotReplayCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,115 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+#include "BasicReplicationGraph.h"
+#include "ItemSlotReplicationGraph.generated.h"
+
+/**
+ * Replication graph node for actors owning UItemSlots (shelves, racks, chests) and for the ASlotableActors that go into them.
+ * They are bucketed in a grid keyed on the center of their slots (an item's own location), a connection only visits the cells
+ * within UItemSlotSettings::SlotRelevancyRadius of its viewers. Actors within that radius but away from the connection's
+ * motion controllers are replicated at a lower frequency, actors no player is near aren't gathered at all.
+ *
+ * Pawns are left to the default routing, slots on a player's body stay relevant with the player.
+ */
+UCLASS()
+class UReplicationGraphNode_ItemSlots : public UReplicationGraphNode
+{
+	GENERATED_BODY()
+
+public:
+	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo) override;
+	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound = true) override;
+	virtual void NotifyResetAllNetworkActors() override;
+	virtual void PrepareForReplication() override;
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+	//	True for actors this node should handle: non-pawn actors with at least one UItemSlot, and ASlotableActors.
+	static bool HandlesActor(const AActor* actor);
+
+	//	Result of the last gather of a connection.
+	struct FConnectionStats
+	{
+		int32 GatheredCells = 0;
+		int32 GatheredOwners = 0;
+		int32 ThrottledOwners = 0;
+	};
+
+	//	An actor a connection gathered, and the replication period in net frames it was given for that connection.
+	struct FGatheredOwner
+	{
+		AActor* Actor = nullptr;
+		int32 ReplicationPeriod = 1;
+	};
+
+	/**
+	* Actors a connection with these viewers gathers and their replication periods. Runs the same selection as
+	* GatherActorListsForConnection, without a connection. Used by the multi-connection automation test.
+	*/
+	void GatherOwners(TArrayView<const FVector> viewLocations, TArrayView<const FVector> handLocations,
+		TArray<FGatheredOwner>& outOwners, FConnectionStats& outStats) const;
+
+	//	Center of the owner's slots, or of the owner itself when it has none (slotable actors, owners without slots yet).
+	static FVector SlotCenter(const AActor* actor);
+
+	int32 NumSlotOwners() const { return owners.Num(); }
+	bool ContainsActor(const AActor* actor) const { return ownerIndices.Contains(actor); }
+	const TMap<TWeakObjectPtr<UNetReplicationGraphConnection>, FConnectionStats>& GetConnectionStats() const { return connectionStats; }
+
+private:
+	struct FSlotOwner
+	{
+		AActor* Actor = nullptr;
+		FIntVector Cell = FIntVector::ZeroValue;
+		FVector Center = FVector::ZeroVector;
+		bool bMovable = false;
+	};
+
+	FIntVector toCell(const FVector& location) const;
+	void addToCell(const FIntVector& cell, AActor* actor);
+	void removeFromCell(const FIntVector& cell, AActor* actor);
+
+	//	Calls visit once for every non-empty cell within SlotRelevancyRadius of one of the view locations.
+	void forEachRelevantCell(TArrayView<const FVector> viewLocations, TFunctionRef<void(const FActorRepListRefView&)> visit) const;
+	//	Whether the owner is within SlotHandRadius of one of the hands, measured from its slot center.
+	bool isNearHand(const AActor* actor, TArrayView<const FVector> handLocations) const;
+	/**
+	* The selection of one connection's gather: visits the relevant cells, gives every actor in them its replication period
+	* (every frame near a hand, ThrottledSlotReplicationPeriod otherwise) and counts them in outStats.
+	*/
+	void gatherConnection(TArrayView<const FVector> viewLocations, TArrayView<const FVector> handLocations, FConnectionStats& outStats,
+		TFunctionRef<void(const FActorRepListRefView&)> onCell, TFunctionRef<void(AActor*, int32)> onOwner) const;
+
+	TArray<FSlotOwner> owners;
+	//	Index in owners, kept in sync with its swap removals.
+	TMap<const AActor*, int32> ownerIndices;
+	TMap<FIntVector, FActorRepListRefView> cells;
+	TMap<TWeakObjectPtr<UNetReplicationGraphConnection>, FConnectionStats> connectionStats;
+};
+
+/**
+ * UBasicReplicationGraph that routes slot owners and slotable actors through UReplicationGraphNode_ItemSlots instead of its spatial grid.
+ * Enable it with ReplicationDriverClassName in the [/Script/OnlineSubsystemUtils.IpNetDriver] section of DefaultEngine.ini.
+ * Projects replicating with Iris use UItemSlotNetObjectFilter instead.
+ */
+UCLASS(Transient, Config = Engine)
+class UItemSlotReplicationGraph : public UBasicReplicationGraph
+{
+	GENERATED_BODY()
+
+public:
+	virtual void InitGlobalGraphNodes() override;
+	virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
+	virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+
+	UReplicationGraphNode_ItemSlots* GetItemSlotNode() const { return itemSlotNode; }
+
+	//	Takes a pooled proxy actor out of the item slot node, so its channels time out and clients drop their copy, or puts it back.
+	void SetActorPooled(AActor* actor, bool pooled);
+
+private:
+	UPROPERTY() TObjectPtr<UReplicationGraphNode_ItemSlots> itemSlotNode;
+};
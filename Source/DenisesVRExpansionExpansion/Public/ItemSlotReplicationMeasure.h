@@ -0,0 +1,55 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AActor;
+class UItemSlot;
+struct FItemSlotNetState;
+
+/**
+ * Estimates what an initial (full) replication of item slot state costs on the wire.
+ * Every replicated property is serialized the way the net driver would, object references are counted as one 32 bit NetGUID.
+ * Used by the DVREE.Slots.MeasureReplication console command and the replication automation tests.
+ */
+struct FItemSlotReplicationMeasure
+{
+	static constexpr int64 NetGUIDBits = 32;
+
+	//	Bits for every replicated property of the object.
+	static int64 MeasureObjectBits(const UObject* object);
+
+	//	Bits for the replicated properties the object has from fromClass and its super classes.
+	static int64 MeasureClassBits(const UObject* object, const UClass* fromClass);
+
+	//	Bits of the slot's netState, the only property a state change dirties.
+	static int64 MeasureSlotStateBits(const UItemSlot* slot);
+
+	//	Bits for the replicated properties of every UItemSlot owned by the actor.
+	static int64 MeasureSlotOwnerBits(const AActor* actor, int32* outSlotNr = nullptr);
+
+	/**
+	* Bits of one property value. Object references are counted as NetGUIDs, everything else is serialized without a package map,
+	* so a natively serialized struct holding object references can't be measured: it fails an ensure and counts as 0.
+	* FItemSlotNetState is the exception, see MeasureNetStateBits.
+	*/
+	static int64 MeasurePropertyBits(const FProperty* property, const void* data);
+
+	/**
+	* Bits the slot's initial replication took before the authoring data stopped replicating. Same walk as MeasureObjectBits
+	* over the old set: the inherited properties, every UItemSlot property that was flagged Replicated (meshes, visuals, materials,
+	* transformRoot, currentlyDisplayedSlotableActor) and the removed state enum and reserved actor, measured through the
+	* FItemSlotNetState members of the same types. Taken from the slot's current values, for a before / after comparison.
+	*/
+	static int64 MeasureLegacySlotBits(const UItemSlot* slot);
+
+	//	Bits of the state's native NetSerialize, its actor counted as a NetGUID.
+	static int64 MeasureNetStateBits(const FItemSlotNetState& state);
+
+	/**
+	* Bits the state would take replicated property by property, the way it was sent before its native NetSerialize:
+	* a byte per enum and per class index, a bit for the proxy flag, a NetGUID for the actor.
+	*/
+	static int64 MeasureReflectedNetStateBits(const FItemSlotNetState& state);
+};
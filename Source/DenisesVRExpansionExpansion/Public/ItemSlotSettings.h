@@ -0,0 +1,144 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DeveloperSettings.h"
+#include "ItemSlotSettings.generated.h"
+
+class UMaterialInterface;
+
+UENUM()
+enum class EItemSlotPreviewRendering : uint8
+{
+	//	Every slot showing a preview borrows its own static mesh component.
+	Components,
+	//	Previews sharing mesh and material are drawn as instances of one UInstancedStaticMeshComponent.
+	Instanced,
+};
+
+/**
+ * Project wide item slot settings, found under Project Settings > Plugins > Item Slots.
+ */
+UCLASS(Config = Game, DefaultConfig, meta = (DisplayName = "Item Slots"))
+class UItemSlotSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+	UItemSlotSettings();
+
+	virtual FName GetCategoryName() const override { return TEXT("Plugins"); }
+
+	static const UItemSlotSettings* Get() { return GetDefault<UItemSlotSettings>(); }
+
+	//	Edge length of a UItemSlotSubsystem grid cell, in cm.
+	UPROPERTY(Config, EditAnywhere, Category = "Slot registry", meta = (ClampMin = "10.0"))
+	float RegistryCellSize = 100.0f;
+
+	//	A new nearest slot has to be this much closer than the reserved one before the reservation moves, in cm.
+	UPROPERTY(Config, EditAnywhere, Category = "Reservation", meta = (ClampMin = "0.0"))
+	float ReservationHysteresisDistance = 5.0f;
+
+	//	Minimum time a reservation is kept before it may move to another slot, in seconds.
+	UPROPERTY(Config, EditAnywhere, Category = "Reservation", meta = (ClampMin = "0.0"))
+	float MinReservationDwellTime = 0.15f;
+
+	/**
+	* Owning clients pick the nearest slot of their gripped actor themselves and show its preview right away.
+	* The server confirms or overrides the choice, a rejected slot is not predicted again until it leaves range.
+	*/
+	UPROPERTY(Config, EditAnywhere, Category = "Reservation")
+	bool bClientPredictedReservations = false;
+
+	/**
+	* Puts actors owning slots to net dormancy while none of their slots is reserved, and wakes them on reservation.
+	* Pawns and actors replicating movement are left alone.
+	*/
+	UPROPERTY(Config, EditAnywhere, Category = "Replication")
+	bool bManageSlotOwnerDormancy = true;
+
+	//	Time per frame the server spends creating the trigger components of slots that began play, in ms. At least one slot is set up per frame.
+	UPROPERTY(Config, EditAnywhere, Category = "Slot registry", meta = (ClampMin = "0.0"))
+	float SlotSetupBudgetMs = 1.0f;
+
+	/**
+	* Spawns slot trigger components only while a gripped ASlotableActor is within LazyTriggerActivationRadius of the slot,
+	* taken from a pool kept by UItemSlotSubsystem. Without it every slot creates its trigger at BeginPlay.
+	*/
+	UPROPERTY(Config, EditAnywhere, Category = "Slot registry")
+	bool bLazySlotTriggers = false;
+
+	//	Distance from a gripped actor's collider within which slots get their trigger, in cm.
+	UPROPERTY(Config, EditAnywhere, Category = "Slot registry", meta = (ClampMin = "0.0", EditCondition = "bLazySlotTriggers"))
+	float LazyTriggerActivationRadius = 100.0f;
+
+	//	Time a lazy trigger is kept after the last gripped actor left its activation radius, in seconds.
+	UPROPERTY(Config, EditAnywhere, Category = "Slot registry", meta = (ClampMin = "0.0", EditCondition = "bLazySlotTriggers"))
+	float LazyTriggerReleaseCooldown = 2.0f;
+
+	//	Grid cell edge length of UReplicationGraphNode_ItemSlots, in cm. Only used with UItemSlotReplicationGraph.
+	UPROPERTY(Config, EditAnywhere, Category = "Replication Graph", meta = (ClampMin = "100.0"))
+	float SlotReplicationCellSize = 1000.0f;
+
+	//	Slot owners further than this from every viewer of a connection are not replicated to it, in cm.
+	UPROPERTY(Config, EditAnywhere, Category = "Replication Graph", meta = (ClampMin = "0.0"))
+	float SlotRelevancyRadius = 3000.0f;
+
+	//	Slot owners within this distance of one of the connection's motion controllers replicate every frame, in cm.
+	UPROPERTY(Config, EditAnywhere, Category = "Replication Graph", meta = (ClampMin = "0.0"))
+	float SlotHandRadius = 200.0f;
+
+	//	Replication period, in net frames, of relevant slot owners away from the connection's hands.
+	UPROPERTY(Config, EditAnywhere, Category = "Replication Graph", meta = (ClampMin = "1"))
+	int32 ThrottledSlotReplicationPeriod = 6;
+
+	//	Slot transitions kept in the server's ring buffer journal (DVREE.Slots.DumpJournal). 0 disables the journal.
+	UPROPERTY(Config, EditAnywhere, Category = "Diagnostics", meta = (ClampMin = "0"))
+	int32 JournalCapacity = 4096;
+
+	//	How reservation previews are drawn. Instanced costs one draw call per mesh and material instead of one per slot.
+	UPROPERTY(Config, EditAnywhere, Category = "Previews")
+	EItemSlotPreviewRendering PreviewRendering = EItemSlotPreviewRendering::Components;
+
+	//	Preview meshes kept loaded after their last use, most recently used first. Others are unloaded once no preview shows them.
+	UPROPERTY(Config, EditAnywhere, Category = "Previews", meta = (ClampMin = "1"))
+	int32 ResidentPreviewMeshes = 16;
+
+	//	Distance from a gripped actor's collider within which slots get their preview mesh streamed in, in cm.
+	UPROPERTY(Config, EditAnywhere, Category = "Previews", meta = (ClampMin = "0.0"))
+	float PreviewPrefetchRadius = 300.0f;
+
+	//	While an ASlotableActor is gripped locally, shows a ghost preview in every available slot near it that accepts it. Always instanced.
+	UPROPERTY(Config, EditAnywhere, Category = "Previews")
+	bool bShowGhostPreviewsWhileGripped = false;
+
+	//	Distance from the gripped actor within which slots show a ghost preview, in cm.
+	UPROPERTY(Config, EditAnywhere, Category = "Previews", meta = (ClampMin = "0.0", EditCondition = "bShowGhostPreviewsWhileGripped"))
+	float GhostPreviewRadius = 500.0f;
+
+	//	Material of the ghost previews. The mesh's own material is used when none is set. Streamed in on the first grip.
+	UPROPERTY(Config, EditAnywhere, Category = "Previews", meta = (EditCondition = "bShowGhostPreviewsWhileGripped"))
+	TSoftObjectPtr<UMaterialInterface> GhostPreviewMaterial;
+
+	/**
+	* Replaces items that sat in a slot without a motion controller near them for ProxyDehydrateDelay by a proxy: the slot keeps
+	* the item's class and ASlotableActor::SerializeProxyData blob, clients render its preview mesh instanced, and the actor goes
+	* back to a pool. It is rehydrated once a motion controller comes within ProxyRehydrateRadius of the slot.
+	* Loadouts (UItemSlotSubsystem::ApplyLoadout) insert proxies right away instead of spawning the actors.
+	*/
+	UPROPERTY(Config, EditAnywhere, Category = "Proxies")
+	bool bProxySlottedItems = false;
+
+	//	Distance from a motion controller within which proxies get their actor back, in cm.
+	UPROPERTY(Config, EditAnywhere, Category = "Proxies", meta = (ClampMin = "0.0", EditCondition = "bProxySlottedItems"))
+	float ProxyRehydrateRadius = 80.0f;
+
+	//	Time an item stays an actor after the last motion controller left its rehydrate radius, in seconds.
+	UPROPERTY(Config, EditAnywhere, Category = "Proxies", meta = (ClampMin = "0.0", EditCondition = "bProxySlottedItems"))
+	float ProxyDehydrateDelay = 5.0f;
+
+	//	Deactivated actors kept for rehydration, over all classes. Proxied actors beyond it are destroyed.
+	UPROPERTY(Config, EditAnywhere, Category = "Proxies", meta = (ClampMin = "0", EditCondition = "bProxySlottedItems"))
+	int32 ProxyActorPoolSize = 32;
+};
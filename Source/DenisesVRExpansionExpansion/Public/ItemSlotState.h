@@ -2,12 +2,86 @@
 
 #pragma once
 
+#include "CoreMinimal.h"
+#include "InputCoreTypes.h"
+#include "Templates/SubclassOf.h"
 #include "ItemSlotState.generated.h"
 
+class ASlotableActor;
+
 UENUM(BlueprintType)
 enum EItemSlotState : int
 {
 	available	UMETA(DisplayName = "available"),
 	reserved	UMETA(DisplayName = "reserved"),
 	occupied	UMETA(DisplayName = "occupied")
-};
\ No newline at end of file
+};
+
+/**
+ * Replicated runtime state of a UItemSlot. Clients rebuild their visuals from it, so it is all they need to converge.
+ * Sent with a native NetSerialize, packed to the bits each field needs: an available slot takes 10 bits,
+ * a reserved or occupied one adds its class index and the actor's NetGUID.
+ */
+USTRUCT()
+struct FItemSlotNetState
+{
+	GENERATED_BODY()
+
+	UPROPERTY() TEnumAsByte<EItemSlotState> State = EItemSlotState::available;
+
+	//	Hand the reservation is for, picks the preview material.
+	UPROPERTY() EControllerHand HandSide = EControllerHand::AnyHand;
+
+	//	Index in the slot's acceptedActors of the class to display, INDEX_NONE when there is nothing to display.
+	UPROPERTY() int8 ClassIndex = INDEX_NONE;
+
+	//	Actor the slot is reserved for, or the actor occupying it. Null while the occupant is a proxy.
+	UPROPERTY() TObjectPtr<AActor> Actor = nullptr;
+
+	//	Occupied by a proxy: the occupant's actor is gone and clients render the ClassIndex visuals in its place.
+	UPROPERTY() bool bProxy = false;
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+	bool operator==(const FItemSlotNetState& other) const
+	{
+		return State == other.State && HandSide == other.HandSide && ClassIndex == other.ClassIndex && Actor == other.Actor && bProxy == other.bProxy;
+	}
+	bool operator!=(const FItemSlotNetState& other) const { return !(*this == other); }
+};
+
+template<>
+struct TStructOpsTypeTraits<FItemSlotNetState> : public TStructOpsTypeTraitsBase2<FItemSlotNetState>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithIdenticalViaEquality = true,
+	};
+};
+
+/**
+ * Server-side record a proxied occupant is rebuilt from, see UItemSlotSettings::bProxySlottedItems.
+ */
+USTRUCT()
+struct FItemSlotProxyRecord
+{
+	GENERATED_BODY()
+
+	//	Exact class of the occupant, may be a child of the accepted class.
+	UPROPERTY() TSubclassOf<ASlotableActor> ActorClass;
+
+	//	Written by ASlotableActor::SerializeProxyData.
+	UPROPERTY() TArray<uint8> Data;
+};
+
+/**
+ * Handle to one instance of an instanced slot preview batch. Invalid by default.
+ */
+struct FItemSlotPreviewInstance
+{
+	int32 Batch = INDEX_NONE;
+	int32 Instance = INDEX_NONE;
+
+	bool IsValid() const { return Instance != INDEX_NONE; }
+};
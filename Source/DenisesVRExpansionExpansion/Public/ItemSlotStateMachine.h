@@ -0,0 +1,140 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ItemSlotState.h"
+
+class UItemSlot;
+class ASlotableActor;
+
+/**
+ * Everything that can change a UItemSlot's state. Each event has one TItemSlotTransition specialization below,
+ * together they are the slot's transition table:
+ *
+ *	Reserve				available			-> reserved		actor of an accepted class
+ *	CancelReservation	reserved			-> available	actor is the reserved one
+ *	Receive				reserved			-> occupied		actor is the reserved one
+ *	Remove				reserved, occupied	-> available	any actor, the slot is emptied regardless
+ *	Insert				available			-> occupied		actor of an accepted class, without a reservation (loadouts)
+ *	InsertProxy			available			-> occupied		no actor, the slot's proxy record has an accepted class
+ *	Dehydrate			occupied			-> occupied		actor is the one in the slot, it is replaced by a proxy
+ *	Rehydrate			occupied			-> occupied		slot holds a proxy, actor set to take its place
+ *
+ * Transitions only run on the server, through UItemSlot::transition. Clients never run them, they derive their side effects
+ * from the replicated FItemSlotNetState.
+ */
+enum class EItemSlotEvent : uint8
+{
+	Reserve,
+	CancelReservation,
+	Receive,
+	Remove,
+	Insert,
+	InsertProxy,
+	Dehydrate,
+	Rehydrate,
+};
+
+namespace ItemSlotStateMachine
+{
+	constexpr uint8 StateBit(EItemSlotState state) { return static_cast<uint8>(1 << state); }
+
+	const TCHAR* EventName(EItemSlotEvent event);
+}
+
+/**
+ * Transition of one event. Specializations provide:
+ * FromStates:	mask of the states the event is legal in, checked before anything else.
+ * Guard:		further conditions on the slot, its current state and the instigating actor.
+ * MakeState:	the state to commit.
+ * OnCommitted:	server-side hook after the state was committed. Visual side effects don't go here, they come from the replicated state.
+ */
+template<EItemSlotEvent Event>
+struct TItemSlotTransition;
+
+template<>
+struct TItemSlotTransition<EItemSlotEvent::Reserve>
+{
+	static constexpr uint8 FromStates = ItemSlotStateMachine::StateBit(EItemSlotState::available);
+
+	//	The slot has to accept the actor's class, its committed ClassIndex is never INDEX_NONE.
+	static bool Guard(const UItemSlot& slot, const FItemSlotNetState& current, const ASlotableActor* actor);
+	static FItemSlotNetState MakeState(const UItemSlot& slot, const FItemSlotNetState& current, ASlotableActor* actor, EControllerHand handSide);
+	static void OnCommitted(UItemSlot& slot) {}
+};
+
+template<>
+struct TItemSlotTransition<EItemSlotEvent::CancelReservation>
+{
+	static constexpr uint8 FromStates = ItemSlotStateMachine::StateBit(EItemSlotState::reserved);
+
+	static bool Guard(const UItemSlot& slot, const FItemSlotNetState& current, const ASlotableActor* actor);
+	static FItemSlotNetState MakeState(const UItemSlot& slot, const FItemSlotNetState& current, ASlotableActor* actor, EControllerHand handSide) { return FItemSlotNetState(); }
+	static void OnCommitted(UItemSlot& slot) {}
+};
+
+template<>
+struct TItemSlotTransition<EItemSlotEvent::Receive>
+{
+	static constexpr uint8 FromStates = ItemSlotStateMachine::StateBit(EItemSlotState::reserved);
+
+	static bool Guard(const UItemSlot& slot, const FItemSlotNetState& current, const ASlotableActor* actor);
+	static FItemSlotNetState MakeState(const UItemSlot& slot, const FItemSlotNetState& current, ASlotableActor* actor, EControllerHand handSide);
+	static void OnCommitted(UItemSlot& slot);
+};
+
+template<>
+struct TItemSlotTransition<EItemSlotEvent::Remove>
+{
+	static constexpr uint8 FromStates = ItemSlotStateMachine::StateBit(EItemSlotState::reserved) | ItemSlotStateMachine::StateBit(EItemSlotState::occupied);
+
+	//	Whoever asks, the slot is emptied. Removing from an available slot is rejected by FromStates only.
+	static bool Guard(const UItemSlot& slot, const FItemSlotNetState& current, const ASlotableActor* actor) { return true; }
+	static FItemSlotNetState MakeState(const UItemSlot& slot, const FItemSlotNetState& current, ASlotableActor* actor, EControllerHand handSide) { return FItemSlotNetState(); }
+	static void OnCommitted(UItemSlot& slot);
+};
+
+template<>
+struct TItemSlotTransition<EItemSlotEvent::Insert>
+{
+	static constexpr uint8 FromStates = ItemSlotStateMachine::StateBit(EItemSlotState::available);
+
+	//	The slot has to accept the actor's class, its committed ClassIndex is never INDEX_NONE.
+	static bool Guard(const UItemSlot& slot, const FItemSlotNetState& current, const ASlotableActor* actor);
+	static FItemSlotNetState MakeState(const UItemSlot& slot, const FItemSlotNetState& current, ASlotableActor* actor, EControllerHand handSide);
+	static void OnCommitted(UItemSlot& slot);
+};
+
+template<>
+struct TItemSlotTransition<EItemSlotEvent::InsertProxy>
+{
+	static constexpr uint8 FromStates = ItemSlotStateMachine::StateBit(EItemSlotState::available);
+
+	//	No actor, and the slot has to accept the proxy record's class. Restored records and replays skip the loadout's
+	//	validation, this keeps their committed ClassIndex from being INDEX_NONE.
+	static bool Guard(const UItemSlot& slot, const FItemSlotNetState& current, const ASlotableActor* actor);
+	static FItemSlotNetState MakeState(const UItemSlot& slot, const FItemSlotNetState& current, ASlotableActor* actor, EControllerHand handSide);
+	static void OnCommitted(UItemSlot& slot);
+};
+
+//	The slot stays occupied through Dehydrate and Rehydrate, so neither raises any event.
+template<>
+struct TItemSlotTransition<EItemSlotEvent::Dehydrate>
+{
+	static constexpr uint8 FromStates = ItemSlotStateMachine::StateBit(EItemSlotState::occupied);
+
+	static bool Guard(const UItemSlot& slot, const FItemSlotNetState& current, const ASlotableActor* actor);
+	static FItemSlotNetState MakeState(const UItemSlot& slot, const FItemSlotNetState& current, ASlotableActor* actor, EControllerHand handSide);
+	static void OnCommitted(UItemSlot& slot) {}
+};
+
+template<>
+struct TItemSlotTransition<EItemSlotEvent::Rehydrate>
+{
+	static constexpr uint8 FromStates = ItemSlotStateMachine::StateBit(EItemSlotState::occupied);
+
+	static bool Guard(const UItemSlot& slot, const FItemSlotNetState& current, const ASlotableActor* actor) { return actor && current.bProxy; }
+	static FItemSlotNetState MakeState(const UItemSlot& slot, const FItemSlotNetState& current, ASlotableActor* actor, EControllerHand handSide);
+	static void OnCommitted(UItemSlot& slot) {}
+};
@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogItemSlots, Log, All);
+
+DECLARE_STATS_GROUP(TEXT("ItemSlots"), STATGROUP_ItemSlots, STATCAT_Advanced);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Reservation switches"), STAT_ItemSlots_ReservationSwitches, STATGROUP_ItemSlots, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Suppressed reservation switches"), STAT_ItemSlots_SuppressedSwitches, STATGROUP_ItemSlots, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Slots compared (awake owners)"), STAT_ItemSlots_ComparedSlots, STATGROUP_ItemSlots, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Slots dirty"), STAT_ItemSlots_DirtySlots, STATGROUP_ItemSlots, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Slot RPCs"), STAT_ItemSlots_Rpcs, STATGROUP_ItemSlots, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Slot availability events"), STAT_ItemSlots_SlotEvents, STATGROUP_ItemSlots, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Rejected slot transitions"), STAT_ItemSlots_RejectedTransitions, STATGROUP_ItemSlots, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Answered reservation predictions"), STAT_ItemSlots_Predictions, STATGROUP_ItemSlots, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Mispredicted reservations"), STAT_ItemSlots_Mispredictions, STATGROUP_ItemSlots, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Active grippers"), STAT_ItemSlots_ActiveGrippers, STATGROUP_ItemSlots, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Candidate slots"), STAT_ItemSlots_CandidateSlots, STATGROUP_ItemSlots, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Active lazy triggers"), STAT_ItemSlots_LazyTriggers, STATGROUP_ItemSlots, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Proxied slot occupants"), STAT_ItemSlots_ProxySlots, STATGROUP_ItemSlots, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Pooled proxy actors"), STAT_ItemSlots_PooledProxyActors, STATGROUP_ItemSlots, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Proxy rehydrations"), STAT_ItemSlots_Rehydrations, STATGROUP_ItemSlots, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Resident preview meshes"), STAT_ItemSlots_ResidentPreviewMeshes, STATGROUP_ItemSlots, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Preview mesh stream requests"), STAT_ItemSlots_PreviewMeshRequests, STATGROUP_ItemSlots, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Slots waiting for setup"), STAT_ItemSlots_PendingSetups, STATGROUP_ItemSlots, );
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Last slot setup total (ms)"), STAT_ItemSlots_SetupTotalMs, STATGROUP_ItemSlots, );
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Last slot setup worst frame (ms)"), STAT_ItemSlots_SetupWorstFrameMs, STATGROUP_ItemSlots, );
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Reservations per second"), STAT_ItemSlots_ReservationsPerSecond, STATGROUP_ItemSlots, );
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Slot RPCs per second"), STAT_ItemSlots_RpcsPerSecond, STATGROUP_ItemSlots, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Rep graph gathered slot owners"), STAT_ItemSlots_RepGraphGathered, STATGROUP_ItemSlots, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Rep graph throttled slot owners"), STAT_ItemSlots_RepGraphThrottled, STATGROUP_ItemSlots, );
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Misprediction rate"), STAT_ItemSlots_MispredictRate, STATGROUP_ItemSlots, );
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Subsystem tick"), STAT_ItemSlots_Tick, STATGROUP_ItemSlots, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Nearest slot solve"), STAT_ItemSlots_Solve, STATGROUP_ItemSlots, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Find compatible slots"), STAT_ItemSlots_FindCompatible, STATGROUP_ItemSlots, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Registry slot refresh"), STAT_ItemSlots_RegistryRefresh, STATGROUP_ItemSlots, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Manual slot search"), STAT_ItemSlots_ManualFind, STATGROUP_ItemSlots, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Find nearest slot"), STAT_ItemSlots_FindNearest, STATGROUP_ItemSlots, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Apply nearest slot"), STAT_ItemSlots_ApplyNearest, STATGROUP_ItemSlots, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Slot overlap events"), STAT_ItemSlots_Overlap, STATGROUP_ItemSlots, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Apply slot state"), STAT_ItemSlots_ApplyNetState, STATGROUP_ItemSlots, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Setup trigger"), STAT_ItemSlots_SetupTrigger, STATGROUP_ItemSlots, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Apply loadout"), STAT_ItemSlots_ApplyLoadout, STATGROUP_ItemSlots, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Deferred slot setup"), STAT_ItemSlots_DeferredSetup, STATGROUP_ItemSlots, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Lazy trigger update"), STAT_ItemSlots_LazyTriggerUpdate, STATGROUP_ItemSlots, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Proxy update"), STAT_ItemSlots_ProxyUpdate, STATGROUP_ItemSlots, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Dispatch slot events"), STAT_ItemSlots_DispatchEvents, STATGROUP_ItemSlots, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Rep graph slot gather"), STAT_ItemSlots_RepGraphGather, STATGROUP_ItemSlots, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Rep graph slot owner update"), STAT_ItemSlots_RepGraphPrepare, STATGROUP_ItemSlots, );
+
+CSV_DECLARE_CATEGORY_EXTERN(ItemSlots);
+
+//	Cycle stat, Insights CPU scope and CSV timing of the same name. Name is the STAT_ItemSlots_ suffix.
+#define ITEMSLOTS_SCOPE(Name) \
+	SCOPE_CYCLE_COUNTER(STAT_ItemSlots_##Name); \
+	TRACE_CPUPROFILER_EVENT_SCOPE(ItemSlots_##Name); \
+	CSV_SCOPED_TIMING_STAT(ItemSlots, Name)
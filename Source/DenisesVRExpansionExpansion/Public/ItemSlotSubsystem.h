@@ -0,0 +1,541 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineTypes.h"
+#include "ItemSlotState.h"
+#include "ItemSlotJournal.h"
+#include "ItemSlotAllocator.h"
+#include "Engine/StreamableManager.h"
+#include "ItemSlotSubsystem.generated.h"
+
+class UItemSlot;
+class ASlotableActor;
+class UStaticMesh;
+class UMaterialInterface;
+class UInstancedStaticMeshComponent;
+class UShapeComponent;
+
+/**
+ * Inline capacity of the per actor slot lists, they only reach the heap when more slots than this are in range at once.
+ * Set from the module's Build.cs, the default here only applies when it isn't.
+ */
+#ifndef ITEMSLOT_INLINE_CANDIDATES
+#define ITEMSLOT_INLINE_CANDIDATES 16
+#endif
+
+using FItemSlotCandidates = TArray<UItemSlot*, TInlineAllocator<ITEMSLOT_INLINE_CANDIDATES, FItemSlotHeapAllocator>>;
+
+/**
+ * One item of a loadout: the slot and either an existing actor or a class to spawn.
+ */
+USTRUCT(BlueprintType)
+struct FItemSlotLoadoutEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item Slots")
+	TObjectPtr<UItemSlot> Slot = nullptr;
+	//	Spawned into the slot when Actor is null.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item Slots")
+	TSubclassOf<ASlotableActor> ActorClass;
+	//	Existing loose actor to put in the slot.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item Slots")
+	TObjectPtr<ASlotableActor> Actor = nullptr;
+};
+
+UENUM(BlueprintType)
+enum class EItemSlotLoadoutResult : uint8
+{
+	Slotted,
+	//	No slot, the slot isn't registered or this isn't the server.
+	InvalidSlot,
+	//	The slot is reserved or occupied, or an earlier entry of the same loadout took it.
+	SlotUnavailable,
+	//	The slot doesn't accept the actor's class.
+	Incompatible,
+	//	The actor is gripped or already in a slot.
+	ActorBusy,
+	SpawnFailed,
+};
+
+/**
+ * World subsystem that keeps every UItemSlot of the world in a uniform grid (spatial hash) keyed by the slot's trigger bounds.
+ * Answers "which compatible slots are near this point" queries without going through physics overlaps.
+ * On the server it also solves the nearest slot for every gripped ASlotableActor once per frame.
+ */
+UCLASS()
+class UItemSlotSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/**
+	* Adds a gripped actor to the batched nearest slot solve. Server only.
+	*/
+	void RegisterGripper(ASlotableActor* actor);
+	void UnregisterGripper(ASlotableActor* actor);
+
+	/**
+	* Adds a gripped actor to the client-side reservation prediction. Owning client only, see UItemSlotSettings::bClientPredictedReservations.
+	*/
+	void RegisterPredictingGripper(ASlotableActor* actor);
+	void UnregisterPredictingGripper(ASlotableActor* actor);
+
+	/**
+	* Adds the slot to the grid. Called by the slot itself on BeginPlay.
+	*/
+	void RegisterSlot(UItemSlot* slot);
+
+	/**
+	* Removes the slot from the grid. Called by the slot itself on EndPlay.
+	*/
+	void UnregisterSlot(UItemSlot* slot);
+
+	/**
+	* Flags the slot's grid cells as outdated. They are recalculated on the next query.
+	*/
+	void MarkSlotMoved(UItemSlot* slot);
+
+	/**
+	* Collects every registered slot whose trigger bounds overlap the given sphere and that is compatible with the provided actor.
+	@param FVector point: Center of the query sphere, in world space.
+	@param float radius: Radius of the query sphere.
+	@param ASlotableActor actor: Actor the slots should be compatible with.
+	@param FItemSlotCandidates outAvailable: Receives the compatible slots that are available for the actor.
+	@param FItemSlotCandidates outUnavailable: Optional. Receives the compatible slots that are reserved for another actor or occupied.
+	*/
+	void FindCompatibleSlotsNear(const FVector& point, float radius, const ASlotableActor* actor, FItemSlotCandidates& outAvailable, FItemSlotCandidates* outUnavailable = nullptr);
+
+	int32 NumRegisteredSlots() const { return registeredSlots.Num() - freeIndices.Num(); }
+
+	/**
+	* Returns the dense compatibility ID of the provided ASlotableActor class, assigning one on first use.
+	* Assigning a new ID updates the compatibility bits of every registered slot once, so lookups afterwards are a single bit test.
+	*/
+	int32 RegisterSlotableClass(UClass* actorClass);
+
+	int32 NumSlotableClasses() const { return slotableClasses.Num(); }
+	UClass* GetSlotableClass(int32 classId) const { return slotableClasses.IsValidIndex(classId) ? slotableClasses[classId].Get() : nullptr; }
+
+	static UItemSlotSubsystem* Get(const UObject* worldContext);
+
+	/**
+	* Counts a nearest slot change, either carried out or held back by the hysteresis / dwell time settings.
+	*/
+	void CountReservationSwitch(bool suppressed);
+
+	/**
+	* Counts a call of one of UItemSlot's server RPCs, for the slot RPC stats.
+	*/
+	void CountRpc();
+
+	/**
+	* Counts a client-side reservation prediction the server answered. Predictions superseded by a newer one before their
+	* answer came in never get a result and aren't counted, so they don't dilute the misprediction rate.
+	*/
+	void CountPredictionResult(bool confirmed);
+
+	/**
+	* Server-side. Called by a slot after its replicated state changed, handles the owner's net dormancy.
+	* When the slot's availability changed, its OnOccupied / OnAvailable broadcast is queued for the end of the frame.
+	* Every call is recorded in the transition journal, along with the EItemSlotEvent that caused it.
+	*/
+	void NotifySlotStateChanged(UItemSlot* slot, const FItemSlotNetState& previousNetState, const FItemSlotNetState& newNetState, uint8 event);
+
+	const FItemSlotJournal& GetJournal() const { return journal; }
+
+	/**
+	* Server-side. Puts every entry's actor in its slot in one go, without the grip / reserve / release chain and its RPCs.
+	* Actors to spawn are created with physics off, so they go straight into their slot. Dormancy flushes and net updates
+	* of the slot owners are done once for the whole loadout, availability events are broadcast once at the end of the frame as usual.
+	* In proxy mode (UItemSlotSettings::bProxySlottedItems) entries without an actor are inserted as proxies, nothing is spawned.
+	@param TArray entries: Slot and actor or class pairs. A slot may only appear once.
+	@param TArray outResults: Receives one result per entry, in entry order.
+	@return Number of entries slotted.
+	*/
+	int32 ApplyLoadout(TConstArrayView<FItemSlotLoadoutEntry> entries, TArray<EItemSlotLoadoutResult>& outResults);
+
+	//	Blueprint version of ApplyLoadout.
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Item Slots", meta = (DisplayName = "Apply Loadout"))
+	int32 ApplySlotLoadout(const TArray<FItemSlotLoadoutEntry>& Entries, TArray<EItemSlotLoadoutResult>& OutResults) { return ApplyLoadout(Entries, OutResults); }
+
+	/**
+	* Server-side, proxy mode (UItemSlotSettings::bProxySlottedItems). Hands out a pooled actor of exactly the provided class,
+	* or spawns one, placed at the slot and marked as residing in it.
+	*/
+	ASlotableActor* AcquireProxyActor(TSubclassOf<ASlotableActor> actorClass, UItemSlot* slot);
+
+	//	Takes the actor out of the game and keeps it for AcquireProxyActor, or destroys it when the pool is full.
+	//	Pooled actors stop being net relevant, clients destroy their copy and get a new one when it is handed out again.
+	void ReleaseProxyActor(ASlotableActor* actor);
+
+	int32 NumProxySlots() const { return proxySlotNr; }
+	int32 NumPooledProxyActors() const { return proxyActorPool.Num(); }
+
+	/**
+	* Commits a journaled state on the slot the way the server would have. A proxy state (bProxy) has no actor, its accepted
+	* class comes from classIndex. Without a journaled classIndex (INDEX_NONE) it is looked up from the actor's class.
+	* Used by the journal replay, not by gameplay code.
+	*/
+	void ReplayTransition(UItemSlot* slot, EItemSlotState state, AActor* actor, EControllerHand handSide, bool bProxy = false, int32 classIndex = INDEX_NONE);
+
+	/**
+	* Feeds a journaled event back into the slot's state machine, guards included. Returns false if the slot rejected it.
+	* Used by the journal replay, not by gameplay code.
+	*/
+	bool ReplayEvent(UItemSlot* slot, EItemSlotEvent event, ASlotableActor* actor, EControllerHand handSide);
+
+	/**
+	* Hands out a hidden preview mesh component attached to the provided slot. The pool grows when it runs dry.
+	* Slots only hold a preview while they display a reservation, so the pool stays around one component per local hand.
+	*/
+	UStaticMeshComponent* BorrowPreviewComponent(USceneComponent* attachTo);
+
+	/**
+	* Hides and detaches the component and puts it back in the pool.
+	*/
+	void ReturnPreviewComponent(UStaticMeshComponent* component);
+
+	/**
+	* Server-side. Queues the slot's finishSetup, run within UItemSlotSettings::SlotSetupBudgetMs per frame so
+	* a level streaming in many slots doesn't create all their triggers in one frame.
+	*/
+	void QueueSlotSetup(UItemSlot* slot);
+
+	int32 NumPendingSlotSetups() const { return pendingSetups.Num(); }
+
+	/**
+	* Server-side, Iris only. Routes a slot owner or slotable actor through UItemSlotNetObjectFilter once it has a replication handle.
+	* Does nothing without Iris or when the filter isn't registered.
+	*/
+	void QueueNetObjectFilter(AActor* actor);
+
+	/**
+	* Hands out a trigger shape from the pool for a slot in lazy trigger mode (UItemSlotSettings::bLazySlotTriggers),
+	* creating one when the pool is empty. Its collision is disabled until the slot set it up.
+	*/
+	UShapeComponent* BorrowTrigger(bool box);
+
+	//	Disables and detaches the trigger and puts it back in the pool.
+	void ReturnTrigger(UShapeComponent* trigger);
+
+	int32 NumLazyTriggers() const { return lazyTriggerSlots.Num(); }
+	int32 NumPooledTriggers() const { return sphereTriggerPool.Num() + boxTriggerPool.Num(); }
+
+	int32 NumPooledPreviewComponents() const { return previewPool.Num(); }
+	int32 NumPreviewComponents() const { return previewComponentNr; }
+
+	/**
+	* Adds an instance to the batch of the provided mesh and material, creating the batch on first use.
+	* Returns an invalid handle on a dedicated server or without a mesh.
+	*/
+	FItemSlotPreviewInstance AddPreviewInstance(UStaticMesh* mesh, UMaterialInterface* material, const FTransform& worldTransform);
+
+	/**
+	* Moves an existing instance. Only that instance is updated.
+	*/
+	void UpdatePreviewInstance(const FItemSlotPreviewInstance& instance, const FTransform& worldTransform);
+
+	/**
+	* Hides the instance and keeps its index for reuse, so no other instance of the batch is touched. Resets the handle.
+	*/
+	void RemovePreviewInstance(FItemSlotPreviewInstance& instance);
+
+	//	True when the handle points to an instance of the batch of the provided mesh and material.
+	bool IsPreviewInstanceOf(const FItemSlotPreviewInstance& instance, const UStaticMesh* mesh, const UMaterialInterface* material) const;
+
+	//	Visible instances of the provided mesh and material. Render independent, so it also works with -nullrhi.
+	int32 NumPreviewInstances(const UStaticMesh* mesh, const UMaterialInterface* material) const;
+	int32 NumPreviewBatches() const { return previewBatches.Num(); }
+
+	/**
+	* Shows an instanced ghost preview in every slot within UItemSlotSettings::GhostPreviewRadius of the provided actor
+	* that is available for and compatible with it. Nothing shows until the ghost material is loaded.
+	* Ghosts are rebuilt on the next tick after a slot state change or a streamed in mesh, see MarkGhostPreviewsDirty.
+	* They don't follow slots that move while they are shown.
+	*/
+	void ShowGhostPreviews(const ASlotableActor* actor);
+	void HideGhostPreviews(const ASlotableActor* actor);
+
+	//	Rebuilds the shown ghost previews on the next tick. Called by slots whose state changed.
+	void MarkGhostPreviewsDirty();
+
+	int32 NumGhostPreviews(const ASlotableActor* actor) const;
+
+	/**
+	* Returns the preview mesh when it is loaded, otherwise starts streaming it in and returns null.
+	* The provided slot gets its preview refreshed once the mesh arrives. Either way the mesh is marked as recently used,
+	* the last UItemSlotSettings::ResidentPreviewMeshes of them are kept loaded.
+	*/
+	UStaticMesh* RequestPreviewMesh(const TSoftObjectPtr<UStaticMesh>& mesh, UItemSlot* waitingSlot = nullptr);
+
+	/**
+	* Starts streaming in the previews the gripped actor may need: its own preview mesh and its visuals in the compatible slots around it.
+	* Does nothing on a dedicated server.
+	*/
+	void PrefetchPreviewMeshes(const ASlotableActor* actor);
+
+	int32 NumResidentPreviewMeshes() const { return residentPreviewMeshIndices.Num(); }
+
+	uint64 GetReservationSwitchCount() const { return reservationSwitchCount; }
+	uint64 GetSuppressedSwitchCount() const { return suppressedSwitchCount; }
+
+	//	Replicated slot state changes so far. Each one goes out to every client the slot is relevant to.
+	uint64 GetStateCommitCount() const { return stateCommitCount; }
+
+	//	Calls of UItemSlot's server RPCs so far.
+	uint64 GetRpcCount() const { return rpcCount; }
+
+	//	Time the last Tick took, in ms.
+	double GetLastTickMs() const { return lastTickMs; }
+
+	uint64 GetPredictionCount() const { return predictionCount; }
+	uint64 GetMispredictionCount() const { return mispredictionCount; }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FRegisteredSlot
+	{
+		//	Weak, the registry doesn't keep slots alive. Slots unregister on EndPlay, a stale entry is skipped until then.
+		TWeakObjectPtr<UItemSlot> Slot;
+		FIntVector MinCell = FIntVector::ZeroValue;
+		FIntVector MaxCell = FIntVector::ZeroValue;
+		FBox Bounds = FBox(ForceInit);
+		uint32 QueryStamp = 0;
+		bool bMoved = false;
+		//	Last time a gripped actor was within the lazy trigger activation radius.
+		double LastTriggerUseTime = 0.0;
+		//	Proxy mode. Occupied by an actor, and the last time a motion controller was within the rehydrate radius.
+		bool bHydrated = false;
+		double LastHandNearTime = 0.0;
+	};
+
+	FIntVector toCell(const FVector& location) const;
+	void addToCells(int32 index);
+	void removeFromCells(int32 index);
+	void flushMovedSlots();
+
+	//	Calls func with every registered slot whose bounds overlap the sphere, once per slot.
+	template<typename FFunc>
+	void forEachSlotNear(const FVector& point, float radius, FFunc&& func);
+
+	bool canManageDormancy(const AActor* owner) const;
+	//	SetNetDormancy, keeping awakeOwnerSlotNr in sync.
+	void setOwnerDormancy(AActor* owner, ENetDormancy dormancy);
+	UStaticMeshComponent* createPreviewComponent();
+	int32 findOrAddPreviewBatch(UStaticMesh* mesh, UMaterialInterface* material);
+	void updateReplicationStats();
+	void updateRateStats(float deltaTime);
+
+	void queueSlotEvent(UItemSlot* slot, bool available);
+
+	void onPreviewMeshLoaded(FSoftObjectPath path);
+	//	Moves an entry of residentPreviewMeshes out of / to the most recently used end of its list.
+	void unlinkResidentPreviewMesh(int32 index);
+	void linkNewestResidentPreviewMesh(int32 index);
+
+	//	Shows the ghosts of every actor in ghostPreviews again when they were marked dirty.
+	void refreshGhostPreviews();
+
+	/**
+	* Broadcasts the availability events queued this frame, one per transition in the order they happened.
+	*/
+	void dispatchSlotEvents();
+
+	/**
+	* Gathers the candidate slots of every registered gripper into flat arrays and picks the nearest one per gripper in a single pass.
+	* Only grippers whose nearest slot changed touch any slot state.
+	*/
+	void solveNearestSlots();
+
+	//	Runs queued slot setups until the frame's budget is spent.
+	void runPendingSetups();
+
+	//	Assigns UItemSlotNetObjectFilter to the queued actors that began replicating.
+	void assignNetObjectFilters();
+
+	/**
+	* Server-side, lazy trigger mode only. Gives slots near gripped actors a pooled trigger and returns the triggers of slots
+	* that had no gripped actor near them for the cooldown.
+	*/
+	void updateLazyTriggers();
+
+	//	Client-side. Updates the predicted reservation of every predicting gripper.
+	void predictReservations();
+
+	/**
+	* Server-side, proxy mode only. Rehydrates the proxies within reach of any player's motion controllers
+	* and dehydrates the slotted actors that had none near them for UItemSlotSettings::ProxyDehydrateDelay.
+	*/
+	void updateProxies();
+	void trackHydratedSlot(int32 index, bool hydrated);
+
+	//	Spawns the actor at the slot with physics off, so it can go straight into the slot.
+	ASlotableActor* spawnSlottedActor(UClass* actorClass, UItemSlot* slot);
+
+	//	Proxy mode, server only. Keeps the record of a proxy slot that unregisters, or restores it when the slot registers again.
+	void keepProxyRecord(UItemSlot* slot);
+	void restoreProxyRecord(UItemSlot* slot);
+
+	TArray<FRegisteredSlot> registeredSlots;
+	TArray<int32> freeIndices;
+	TArray<int32, FItemSlotHeapAllocator> movedSlots;
+	TMap<FIntVector, TArray<int32, TInlineAllocator<4>>> grid;
+
+	//	Classes that received a compatibility ID, indexed by that ID.
+	UPROPERTY() TArray<TObjectPtr<UClass>> slotableClasses;
+	TMap<UClass*, int32> slotableClassIds;
+
+	//	While ApplyLoadout runs, owners whose dormancy flush is deferred to its end.
+	TSet<AActor*>* deferredFlushOwners = nullptr;
+
+	//	Number of reserved slots per slot owner, owners without an entry are kept dormant.
+	TMap<TWeakObjectPtr<AActor>, int32> ownerActiveSlots;
+
+	//	Registered slots per owner and whether the owner was awake when last seen, for the compared slots stat.
+	struct FOwnerSlots
+	{
+		int32 SlotNr = 0;
+		bool bAwake = false;
+	};
+	TMap<TWeakObjectPtr<AActor>, FOwnerSlots> ownerSlots;
+	//	Slots of awake owners, kept up to date on registration and on every dormancy change made here.
+	int32 awakeOwnerSlotNr = 0;
+
+	FItemSlotJournal journal;
+
+	//	Registry indices of slots whose availability changed this frame.
+	struct FSlotEvent
+	{
+		//	Registry index of the slot, INDEX_NONE once it unregistered.
+		int32 Index = INDEX_NONE;
+		bool bAvailable = false;
+	};
+	TArray<FSlotEvent, FItemSlotHeapAllocator> pendingSlotEvents;
+	TArray<FSlotEvent, FItemSlotHeapAllocator> dispatchingSlotEvents;
+
+	//	Slots waiting for finishSetup, oldest first. Weak, so a slot destroyed without EndPlay is skipped instead of set up.
+	TArray<TWeakObjectPtr<UItemSlot>> pendingSetups;
+
+#if UE_WITH_IRIS
+	//	Actors waiting for their replication handle before they can be assigned UItemSlotNetObjectFilter.
+	TArray<TWeakObjectPtr<AActor>> pendingFilterActors;
+#endif
+
+	//	Setup work since the queue was last empty.
+	struct FSetupBatch
+	{
+		int32 SlotNr = 0;
+		int32 FrameNr = 0;
+		double TotalMs = 0.0;
+		double WorstFrameMs = 0.0;
+	};
+	FSetupBatch setupBatch;
+
+	//	Registry indices of slots holding a lazy trigger.
+	TArray<int32> lazyTriggerSlots;
+	FItemSlotCandidates lazyTriggerCandidates;
+
+	//	Idle lazy triggers, owned by the world settings actor.
+	UPROPERTY() TArray<TObjectPtr<UShapeComponent>> sphereTriggerPool;
+	UPROPERTY() TArray<TObjectPtr<UShapeComponent>> boxTriggerPool;
+
+	//	Idle preview components, owned by the world settings actor. Never filled on a dedicated server.
+	UPROPERTY() TArray<TObjectPtr<UStaticMeshComponent>> previewPool;
+	int32 previewComponentNr = 0;
+
+	struct FPreviewBatch
+	{
+		UInstancedStaticMeshComponent* Component = nullptr;
+		//	Hidden instances that can be reused.
+		TArray<int32> FreeInstances;
+	};
+
+	//	Instanced preview batches, one per mesh and material pair.
+	TArray<FPreviewBatch> previewBatches;
+	TMap<TPair<const UStaticMesh*, const UMaterialInterface*>, int32> previewBatchIds;
+	UPROPERTY() TArray<TObjectPtr<UInstancedStaticMeshComponent>> previewBatchComponents;
+
+	FStreamableManager previewStreamer;
+
+	//	Recently used preview meshes, linked from the least to the most recently used one. The handles keep them loaded.
+	struct FResidentPreviewMesh
+	{
+		FSoftObjectPath Path;
+		TSharedPtr<FStreamableHandle> Handle;
+		int32 Older = INDEX_NONE;
+		int32 Newer = INDEX_NONE;
+	};
+	TArray<FResidentPreviewMesh> residentPreviewMeshes;
+	TMap<FSoftObjectPath, int32> residentPreviewMeshIndices;
+	TArray<int32> freeResidentPreviewMeshes;
+	int32 oldestResidentPreviewMesh = INDEX_NONE;
+	int32 newestResidentPreviewMesh = INDEX_NONE;
+
+	//	Slots showing nothing until the mesh at the path is loaded.
+	TMap<FSoftObjectPath, TArray<TWeakObjectPtr<UItemSlot>>> previewMeshWaiters;
+
+	//	Ghost preview instances per gripped actor.
+	TMap<TWeakObjectPtr<const ASlotableActor>, TArray<FItemSlotPreviewInstance>> ghostPreviews;
+	bool bGhostPreviewsDirty = false;
+
+	//	Keeps UItemSlotSettings::GhostPreviewMaterial loaded once it was requested.
+	TSharedPtr<FStreamableHandle> ghostMaterialHandle;
+
+	//	Query results of PrefetchPreviewMeshes and updateProxies, kept so their storage is reused between frames.
+	FItemSlotCandidates prefetchSlots;
+	FItemSlotCandidates rehydrateSlots;
+
+	//	Proxy mode. Registry indices of slots occupied by an actor, which may be dehydrated.
+	TArray<int32> hydratedSlots;
+	int32 proxySlotNr = 0;
+
+	//	Deactivated actors waiting for a proxy to rehydrate.
+	UPROPERTY() TArray<TObjectPtr<ASlotableActor>> proxyActorPool;
+
+	//	Proxy records of slots whose level streamed out, put back when the slot registers again.
+	UPROPERTY() TMap<FSoftObjectPath, FItemSlotProxyRecord> unregisteredProxyRecords;
+
+	//	Gripped actors, server only. Weak, an actor destroyed without EndPlay (streaming, GC) is dropped by the next solve.
+	TArray<TWeakObjectPtr<ASlotableActor>> grippers;
+
+	//	Gripped actors predicting their reservation, owning client only.
+	TArray<TWeakObjectPtr<ASlotableActor>> predictingGrippers;
+
+	//	Solver scratch buffers, kept between frames so the solve doesn't allocate once they have grown.
+	TArray<float, FItemSlotHeapAllocator> candidateX;
+	TArray<float, FItemSlotHeapAllocator> candidateY;
+	TArray<float, FItemSlotHeapAllocator> candidateZ;
+	TArray<float, FItemSlotHeapAllocator> candidateDistances;
+	TArray<UItemSlot*, FItemSlotHeapAllocator> candidateSlots;
+	TArray<int32, FItemSlotHeapAllocator> gripperCandidateEnd;
+
+	float cellSize = 100.0f;
+	uint32 queryStamp = 0;
+
+	uint64 reservationSwitchCount = 0;
+	uint64 suppressedSwitchCount = 0;
+	uint64 stateCommitCount = 0;
+	uint64 rpcCount = 0;
+	double lastTickMs = 0.0;
+	uint64 predictionCount = 0;
+	uint64 mispredictionCount = 0;
+
+	//	Window of the per second stats.
+	float rateWindowTime = 0.0f;
+	uint64 rateWindowReservations = 0;
+	uint64 rateWindowRpcs = 0;
+	uint64 rateWindowPredictions = 0;
+	uint64 rateWindowMispredictions = 0;
+};
@@ -9,6 +9,7 @@
 #include "ItemGripState.h"
 #include "GripMotionControllerComponent.h"
 #include "ItemSlot.h"
+#include "ItemSlotSubsystem.h"
 #include "SlotableActor.generated.h"
 
 /**
@@ -23,13 +24,36 @@ class ASlotableActor : public AGrippableActor
 public:
 	ASlotableActor(const FObjectInitializer& ObjectInitializer);
 
-	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Static values", meta = (DisplayName = "Preview Mesh", MakeStructureDefaultValue = ""))
+	//	Kept for existing blueprints. Moved into SoftPreviewMesh on load in the editor, so saved assets no longer reference the mesh.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Static values", meta = (DisplayName = "Preview Mesh (deprecated)", MakeStructureDefaultValue = "", DeprecatedProperty, DeprecationMessage = "Use SoftPreviewMesh, it is streamed in when a slot needs it."))
 		TObjectPtr<UStaticMesh> PreviewMesh;
+	//	Soft, so slots don't load the preview of every class they accept. Streamed in by UItemSlotSubsystem::RequestPreviewMesh.
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Static values", meta = (DisplayName = "Preview Mesh", MakeStructureDefaultValue = ""))
+		TSoftObjectPtr<UStaticMesh> SoftPreviewMesh;
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Static values", meta = (DisplayName = "Scale", MakeStructureDefaultValue = "1.000000,1.000000,1.000000"))
 		FVector MeshScale;
 
+	//	SoftPreviewMesh, or the deprecated PreviewMesh while a blueprint still sets only that one.
+	TSoftObjectPtr<UStaticMesh> GetPreviewMesh() const { return SoftPreviewMesh.IsNull() ? TSoftObjectPtr<UStaticMesh>(PreviewMesh.Get()) : SoftPreviewMesh; }
+
+	virtual void PostLoad() override;
+
+	//	Pooled proxy actors are never net relevant, see UItemSlotSubsystem::ReleaseProxyActor.
+	virtual bool IsNetRelevantFor(const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation) const override;
+	bool IsPooled() const { return bPooled; }
+
+	//	Dense class ID assigned by UItemSlotSubsystem on BeginPlay, used for the slot compatibility bit test.
+	int32 GetSlotClassIndex() const { return slotClassIndex; }
+
+	/**
+	* Server-side, proxy mode only (UItemSlotSettings::bProxySlottedItems). Instance data that survives the actor being replaced by a proxy:
+	* called with a saving archive before the actor leaves its slot for the pool, and with a loading one on the actor that takes
+	* its place, after it began play. Nothing is kept by default.
+	*/
+	virtual void SerializeProxyData(FArchive& Ar) {}
+
 protected:
-	UPROPERTY(Replicated, BlueprintReadOnly, VisibleAnywhere)							UPrimitiveComponent* rootAsPrimitiveComponent;
+	UPROPERTY(BlueprintReadOnly, VisibleAnywhere)										UPrimitiveComponent* rootAsPrimitiveComponent;
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")				USphereComponent* ColliderComponent;
 	UPROPERTY(Replicated, BlueprintReadOnly, VisibleAnywhere, Category = "Grip info")	TEnumAsByte<EItemGripState> currentGripState = EItemGripState::loose;
 	UPROPERTY(Replicated, BlueprintReadOnly, VisibleAnywhere, Category = "Grip info")	UGripMotionControllerComponent* currentGrippingController = nullptr;
@@ -37,10 +61,16 @@ protected:
 
 	UPROPERTY(Replicated) UItemSlot* current_ResidingSlot = nullptr;
 	UPROPERTY(Replicated) UItemSlot* currentNearestSlot = nullptr;
-	TArray<UItemSlot*> currentlyAvailable_Slots;
+	FItemSlotCandidates currentlyAvailable_Slots;
+	//	Registry query results, members so their storage is reused between frames once a query outgrew the inline capacity.
+	FItemSlotCandidates nearAvailableScratch;
+	FItemSlotCandidates nearUnavailableScratch;
+	int32 slotClassIndex = INDEX_NONE;
+	float lastReservationSwitchTime = 0.0f;
+	//	Nearer slot the current reservation is held against, so a hold is counted as one suppressed switch.
+	TWeakObjectPtr<UItemSlot> heldBackSlot;
 
 	virtual void BeginPlay() override;
-	virtual void Tick(float deltaSeconds) override;
 	void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	virtual void OnGrip_Implementation(UGripMotionControllerComponent* GrippingController, const FBPActorGripInformation& GripInformation) override;
@@ -49,12 +79,45 @@ protected:
 	virtual void OnGripRelease_Implementation(UGripMotionControllerComponent* ReleasingController, const FBPActorGripInformation& GripInformation, bool bWasSocketed = false) override;
 	UFUNCTION(NetMulticast, Reliable) void Server_GripRelease(UGripMotionControllerComponent* ReleasingController);
 
+	/**
+	* Sent by the owning client when its predicted nearest slot changed. The server reserves the slot if it is a valid candidate
+	* there as well, and answers with the slot it ended up reserving.
+	*/
+	UFUNCTION(Server, Reliable) void Server_PredictReservation(UItemSlot* slot, uint16 predictionId);
+	UFUNCTION(Client, Reliable) void Client_AckReservation(uint16 predictionId, UItemSlot* reservedSlot);
+
 
 private:
+	friend class UItemSlotSubsystem;
+
 	void setupColliderRef();
 	void manualFindAvailableSlotsCall();
 
-	UFUNCTION(Server, Reliable) void refreshNearestSlot();
+	//	Syncs the slot lists with the registry-only slots (UItemSlot::bUseSpatialRegistryOnly) around ColliderComponent.
+	void refreshRegistrySlots();
+
+	//	Re-evaluates the nearest slot right away, for changes to the slot lists. Per-frame solving is batched in UItemSlotSubsystem.
+	void refreshNearestSlot();
+
+	//	Moves the reservation to the provided slot if it differs from currentNearestSlot.
+	//	While the current reservation is still valid the move is subject to UItemSlotSettings hysteresis and dwell time.
+	void applyNearestSlot(UItemSlot* newNearest, bool skipHold = false);
+	bool shouldHoldReservation(const UItemSlot* newNearest) const;
+
+	//	Client prediction (UItemSlotSettings::bClientPredictedReservations), only on the owning client.
+	TWeakObjectPtr<UItemSlot> predictedSlot;
+	//	Slot the server turned down, not predicted again until it leaves the candidates.
+	TWeakObjectPtr<UItemSlot> rejectedPredictionSlot;
+	uint16 predictionId = 0;
+
+	//	Server-side. Slot the owning client predicted and the server accepted. The solver keeps it for as long as the grip is held
+	//	and the slot stays a candidate, so the server doesn't move the reservation away from what the client shows.
+	TWeakObjectPtr<UItemSlot> clientPredictedSlot;
+
+	//	Client-side. Picks the nearest slot from the replicated slot states and shows its preview without waiting for the server.
+	void updatePredictedReservation();
+	void clearPredictedReservation();
+
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 	
 	UFUNCTION() void checkForSlotOnOverlapBegin(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
@@ -64,18 +127,32 @@ private:
 	void removeSlotFromList(UItemSlot* slotToRemove);
 	void addSlotToList(UItemSlot* slotToAdd, bool skipNearestRefresh = false);
 	void reset_GrippingParameters();
-	UItemSlot* findNearestSlot(TArray<UItemSlot*> slotsToCheck);
+
+	//	Server-side. Marks this actor as residing in the slot, for slot insertions that skip the grip / release path.
+	void setResidingSlot(UItemSlot* slot);
+
+	//	Server-side. Takes the actor out of the game for UItemSlotSubsystem's proxy actor pool, or puts it back.
+	void setPooled(bool pooled);
+	bool bPooled = false;
+	UItemSlot* findNearestSlot(const FItemSlotCandidates& slotsToCheck) const;
 
 
 	//	availability events
-	//FDelegateHandle OccupiedEventHandle;
-	//TMap<UItemSlot*, FDelegateHandle> AvailableEventHandles;
+	struct FSlotSubscription
+	{
+		//	Weak, the slot may be destroyed while this actor still waits on it.
+		TWeakObjectPtr<UItemSlot> Slot;
+		FDelegateHandle Handle;
+	};
+	using FSlotSubscriptions = TArray<FSlotSubscription, TInlineAllocator<ITEMSLOT_INLINE_CANDIDATES, FItemSlotHeapAllocator>>;
+
+	//	Slot lists are unordered, entries are swap-removed.
+	FSlotSubscriptions availableSubscriptions;
 
-	TArray<UItemSlot*> becomeAvailableSlots;
-	TArray<UItemSlot*> becomeOccupiedSlots;
+	static int32 findSubscription(const FSlotSubscriptions& subscriptions, const UItemSlot* slot);
+	void onSlotAvailable(UItemSlot* slot);
 
-	void subscribeToSlotOccupiedEvent(UItemSlot* slot);
-	void unsubscribeFromOccupiedEvent(UItemSlot* slot);
 	void subscribeToSlotAvailableEvent(UItemSlot* slot);
 	void unsubscribeFromAvailableEvent(UItemSlot* slot);
+	void unsubscribeFromAllSlots();
 };
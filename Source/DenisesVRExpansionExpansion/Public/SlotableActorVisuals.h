@@ -13,9 +13,9 @@ public:
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (DisplayName = "ID", MakeStructureDefaultValue = "None"))
 		FString ID;
 
-	/** Please add a variable description */
+	//	Soft, so slots don't load the preview of every class they accept. Streamed in by UItemSlotSubsystem::RequestPreviewMesh.
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (DisplayName = "Mesh", MakeStructureDefaultValue = "None"))
-		TObjectPtr<UStaticMesh> Mesh;
+		TSoftObjectPtr<UStaticMesh> Mesh;
 
 	/** Please add a variable description */
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (DisplayName = "Scale", MakeStructureDefaultValue = "1.000000,1.000000,1.000000"))